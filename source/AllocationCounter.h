@@ -0,0 +1,75 @@
+#pragma once
+#include<algorithm>
+#include<atomic>
+#include<cstddef>
+#include<cstdlib>
+#include<new>
+/**
+* \brief Counts the allocations of the program, main.cpp uses it to prove that an operation does not allocate,
+* benchmark.cpp reports the number and the bytes of the allocations of every operation.
+* Every form of the global new and delete is replaced, so the pairs always match. The counters are atomic,
+* some of the tests and benchmarks allocate from many threads.
+* The replacements are not inline, so the header has to be included by exactly one translation unit of an executable.
+*/
+static std::atomic<unsigned long long> allocations(0);
+static std::atomic<unsigned long long> allocatedBytes(0);
+
+namespace AllocationCounterDetail {
+	static void* allocate(std::size_t size) {
+		allocations.fetch_add(1, std::memory_order_relaxed);
+		allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+		if (void* memory = std::malloc(size ? size : 1))
+			return memory;
+		throw std::bad_alloc();
+	}
+	static void* allocate(std::size_t size, std::align_val_t alignment) {
+		allocations.fetch_add(1, std::memory_order_relaxed);
+		allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+		std::size_t align = std::max(std::size_t(alignment), sizeof(void*));
+#if defined(_WIN32)
+		if (void* memory = _aligned_malloc(size ? size : 1, align))
+			return memory;
+#else
+		void* memory = nullptr;
+		if (posix_memalign(&memory, align, size ? size : 1) == 0)
+			return memory;
+#endif
+		throw std::bad_alloc();
+	}
+	static void release(void* memory, std::align_val_t) {
+#if defined(_WIN32)
+		_aligned_free(memory);
+#else
+		std::free(memory);
+#endif
+	}
+}
+
+void* operator new(std::size_t size) { return AllocationCounterDetail::allocate(size); }
+void* operator new[](std::size_t size) { return AllocationCounterDetail::allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return AllocationCounterDetail::allocate(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return AllocationCounterDetail::allocate(size, alignment); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	try { return AllocationCounterDetail::allocate(size); } catch (const std::bad_alloc&) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+	try { return AllocationCounterDetail::allocate(size); } catch (const std::bad_alloc&) { return nullptr; }
+}
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	try { return AllocationCounterDetail::allocate(size, alignment); } catch (const std::bad_alloc&) { return nullptr; }
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	try { return AllocationCounterDetail::allocate(size, alignment); } catch (const std::bad_alloc&) { return nullptr; }
+}
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t alignment) noexcept { AllocationCounterDetail::release(memory, alignment); }
+void operator delete[](void* memory, std::align_val_t alignment) noexcept { AllocationCounterDetail::release(memory, alignment); }
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept { AllocationCounterDetail::release(memory, alignment); }
+void operator delete[](void* memory, std::size_t, std::align_val_t alignment) noexcept { AllocationCounterDetail::release(memory, alignment); }
+void operator delete(void* memory, std::align_val_t alignment, const std::nothrow_t&) noexcept { AllocationCounterDetail::release(memory, alignment); }
+void operator delete[](void* memory, std::align_val_t alignment, const std::nothrow_t&) noexcept { AllocationCounterDetail::release(memory, alignment); }
@@ -0,0 +1,1318 @@
+#pragma once
+#include<cstddef>
+#include<iostream>
+#include<memory>
+#include<type_traits>
+#include<utility>
+#include<algorithm>
+#include<functional>
+#include"Dictionary.h"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include<emmintrin.h>
+#define DICTIONARY_SSE2
+#endif
+
+namespace DictionaryDetail {
+	/**
+	* Searching inside of a B+ tree node. countLess outputs the number of keys less than key,
+	* countNotGreater the number of keys not greater than key. Keys of the node are sorted.
+	* Other keys are binary searched with comp, arithmetic keys ordered with std::less are compared with all of the keys
+	* of the node without branches, so the compiler can vectorise the loop, int keys are compared four at once with SSE2.
+	*/
+	template<typename Key, typename K, typename Compare>
+	std::size_t countLess(const Key* keys, std::size_t count, const K& key, const Compare& comp, std::false_type) {
+		return std::lower_bound(keys, keys + count, key, comp) - keys;
+	}
+	template<typename Key, typename K, typename Compare>
+	std::size_t countNotGreater(const Key* keys, std::size_t count, const K& key, const Compare& comp, std::false_type) {
+		return std::upper_bound(keys, keys + count, key, comp) - keys;
+	}
+	template<typename Key, typename Compare>
+	std::size_t countLess(const Key* keys, std::size_t count, const Key& key, const Compare&, std::true_type) {
+		std::size_t result = 0;
+		for (std::size_t i = 0; i < count; i++)
+			result += keys[i] < key;
+		return result;
+	}
+	template<typename Key, typename Compare>
+	std::size_t countNotGreater(const Key* keys, std::size_t count, const Key& key, const Compare&, std::true_type) {
+		std::size_t result = 0;
+		for (std::size_t i = 0; i < count; i++)
+			result += !(key < keys[i]);
+		return result;
+	}
+#ifdef DICTIONARY_SSE2
+	/**
+	* Number of set bits of a 4-bit mask.
+	*/
+	inline std::size_t bitCount(int mask) {
+		return (mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + ((mask >> 3) & 1);
+	}
+	template<typename Compare>
+	std::size_t countLess(const int* keys, std::size_t count, const int& key, const Compare&, std::true_type) {
+		const __m128i value = _mm_set1_epi32(key);
+		std::size_t result = 0;
+		std::size_t i = 0;
+		for (; i + 4 <= count; i += 4) {
+			__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+			result += bitCount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(block, value))));
+		}
+		for (; i < count; i++)
+			result += keys[i] < key;
+		return result;
+	}
+	template<typename Compare>
+	std::size_t countNotGreater(const int* keys, std::size_t count, const int& key, const Compare&, std::true_type) {
+		const __m128i value = _mm_set1_epi32(key);
+		std::size_t result = 0;
+		std::size_t i = 0;
+		for (; i + 4 <= count; i += 4) {
+			__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+			result += 4 - bitCount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(block, value))));
+		}
+		for (; i < count; i++)
+			result += !(key < keys[i]);
+		return result;
+	}
+#endif
+}
+/**
+* \brief B+ tree based dictionary, selected with the BPlusTree<Fanout> storage policy:
+* Dictionary<int, int, std::less<int>, std::allocator<std::pair<const int, int>>, BPlusTree<64>> x; or shorter BPlusDictionary<int, int> x;
+* Every node keeps up to Fanout keys in a sorted array, so a lookup takes one or two cache misses per level
+* instead of one per key. Elements are stored only in the leaves and the leaves are linked, so iterating is a scan of arrays.
+* Key and Info have to be default constructible and move assignable. Any insertion or removal invalidates the iterators.
+* Set operations, order statistics, node handles and freeze() are provided only by the AVL storage.
+*/
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+class Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>> {
+	static_assert(Fanout >= 4, "Fanout has to be at least 4");
+public:
+	/**
+	* \brief Types of traversing the tree. Elements are kept only in the leaves, so every type visits them in order.
+	*/
+	enum class TravelType {
+		Preorder,
+		Inorder,
+		Postorder
+	};
+private:
+	struct NodeBase {
+		//number of elements in a leaf, number of children in an inner node
+		std::size_t count;
+		bool leaf;
+		NodeBase(bool isLeaf) : count(0), leaf(isLeaf) {}
+	};
+	struct Leaf : NodeBase {
+		Key keys[Fanout];
+		Info infos[Fanout];
+		Leaf* prev;
+		Leaf* next;
+		Leaf() : NodeBase(true), prev(nullptr), next(nullptr) {}
+	};
+	struct Inner : NodeBase {
+		//children[i] holds the keys from [keys[i - 1], keys[i])
+		Key keys[Fanout - 1];
+		NodeBase* children[Fanout];
+		Inner() : NodeBase(false) {}
+	};
+	typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Leaf> LeafAllocator;
+	typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Inner> InnerAllocator;
+	typedef std::allocator_traits<LeafAllocator> LeafTraits;
+	typedef std::allocator_traits<InnerAllocator> InnerTraits;
+	/**
+	* The height is at most log(n) with base Fanout / 2, so it never reaches that.
+	*/
+	static const int MaxHeight = 64;
+	static const std::size_t MinLeaf = Fanout / 2;
+	static const std::size_t MinInner = Fanout / 2;
+	/**
+	* The branchless search is used only when it gives the same result as comp.
+	*/
+	template<typename K>
+	using FastSearch = std::integral_constant<bool, std::is_arithmetic<Key>::value and std::is_same<K, Key>::value and
+		(std::is_same<Compare, std::less<Key>>::value or std::is_same<Compare, std::less<>>::value)>;
+	NodeBase* head;
+	Leaf* first;
+	Leaf* last;
+	std::size_t elements;
+	int height;
+	LeafAllocator alloc;
+	Compare comp;
+	Leaf* createLeaf();
+	Inner* createInner();
+	void destroyNode(NodeBase* curr);
+	/**
+	* Deletes the subtree.
+	*/
+	void clear(NodeBase* curr);
+	/**
+	* Copies the subtree, the leaves are linked after prevLeaf. If anything throws the copied part is deleted.
+	*/
+	NodeBase* copy(const NodeBase* curr, Leaf*& prevLeaf);
+	/**
+	* Index of the child of an inner node which may contain key.
+	*/
+	template<typename K>
+	std::size_t childIndex(const Inner* curr, const K& key) const;
+	/**
+	* Position of the first key of a leaf which is not less than key.
+	*/
+	template<typename K>
+	std::size_t leafPosition(const Leaf* curr, const K& key) const;
+	/**
+	* Outputs the leaf which may contain key, nullptr if the tree is empty.
+	*/
+	template<typename K>
+	Leaf* findLeaf(const K& key) const;
+	/**
+	* Inserts the element, the info is obtained from make() only when the key is not in the tree yet.
+	* Outputs false when the key is already in the tree. In both cases leaf and pos point to the element.
+	* Approche: The path is remembered during the descent. Full nodes are split bottom up, the new nodes
+	* are allocated before anything is changed, so an exception leaves the tree untouched.
+	*/
+	template<typename K, typename Make>
+	bool insert(const K& key, Leaf*& leaf, std::size_t& pos, Make make);
+	/**
+	* Descents used by the lookups, K is Key or (with a transparent Compare) anything comparable with Key.
+	* search outputs the leaf and the position of the element with the key, nullptr if there is none.
+	* lowerBound/upperBound output the first element which key is not less/greater than key, nullptr if there is none.
+	*/
+	template<typename K>
+	Leaf* search(const K& key, std::size_t& pos) const;
+	template<typename K>
+	Leaf* lowerBound(const K& key, std::size_t& pos) const;
+	template<typename K>
+	Leaf* upperBound(const K& key, std::size_t& pos) const;
+	/**
+	* Removes children[index] and the key before it from an inner node.
+	*/
+	static void removeChild(Inner* curr, std::size_t index);
+	/**
+	* Unlinks the leaf from the list of leaves.
+	*/
+	void unlinkLeaf(Leaf* curr);
+public:
+	/**
+	* Iterator of the B+ tree, it is a leaf and a position in it.
+	*/
+	class iterator {
+		friend Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>;
+		const Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>* master;
+		mutable Leaf* leaf;
+		mutable std::size_t pos;
+		iterator(Leaf* x, std::size_t p, const Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>* m);
+	public:
+		iterator();
+		iterator(const iterator& x) = default;
+		~iterator() = default;
+
+		iterator& operator=(const iterator& x) = default;
+
+		bool operator==(const iterator& x) const;
+
+		bool operator!=(const iterator& x) const;
+
+		const iterator& operator++() const;
+
+		iterator operator++(int) const;
+
+		const iterator& operator--() const;
+
+		iterator operator--(int) const;
+
+		const Info& operator*() const;
+
+		Info& operator*();
+
+		const Key& getKey() const;
+
+		const Info& getInfo() const;
+
+		bool isNull() const;
+
+		friend std::ostream& operator<<(std::ostream& out, const iterator& it) {
+			if (it.isNull()) {
+				out << "Key: " << " - " << ", info: " << " - ";
+			}
+			else {
+				out << "Key: " << it.getKey() << ", info: " << it.getInfo();
+			}
+			return out;
+		}
+	};
+	/**
+	* Reverse iterator of the B+ tree.
+	*/
+	class reverse_iterator : public iterator {
+		friend Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>;
+		reverse_iterator(Leaf* x, std::size_t p, const Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>* m);
+	public:
+		reverse_iterator();
+
+		reverse_iterator(const reverse_iterator& x) = default;
+
+		~reverse_iterator() = default;
+
+		reverse_iterator& operator=(const reverse_iterator& x) = default;
+
+		const reverse_iterator& operator++() const;
+
+		reverse_iterator operator++(int) const;
+
+		const reverse_iterator& operator--() const;
+
+		reverse_iterator operator--(int) const;
+	};
+	typedef const iterator const_iterator;
+	typedef const reverse_iterator const_reverse_iterator;
+	/**
+	* An iterator to the smalles element of the tree. O(1).
+	*/
+	iterator begin() const;
+	/**
+	* An iterator to the end.
+	*/
+	iterator end() const;
+	/**
+	* An reverese iterator to the biggest element of the tree. O(1).
+	*/
+	reverse_iterator rbegin() const;
+	/**
+	* An iterator to the end.
+	*/
+	reverse_iterator rend() const;
+	/**
+	* Constructor creates an empty tree.
+	*/
+	Dictionary();
+	/**
+	* Constructor creates an empty tree which is going to use a given allocator.
+	*/
+	explicit Dictionary(const Allocator& a);
+	/**
+	* Constructor creates an empty tree which is going to order the keys with a given comparator.
+	*/
+	explicit Dictionary(const Compare& c, const Allocator& a = Allocator());
+	/**
+	* Copy constructor.
+	*/
+	Dictionary(const Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>& x);
+	/**
+	* Move constructor. Takes over the nodes of x in O(1), x is left empty.
+	*/
+	Dictionary(Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>&& x) noexcept;
+	/**
+	* Destructor.
+	*/
+	~Dictionary();
+	/**
+	* Outputs the number of levels of the tree. O(1).
+	*/
+	int getHeight() const;
+	/**
+	* Outputs the number of elements. O(1).
+	*/
+	std::size_t size() const;
+	/**
+	* Checks whether the tree is empty.
+	*/
+	bool empty() const;
+	/**
+	* Deletes all of the elements from the tree.
+	*/
+	void clear();
+	/**
+	* Assign operator.
+	*/
+	Dictionary& operator=(const Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>& x);
+	/**
+	* Move assign operator, same as in the AVL storage.
+	*/
+	Dictionary& operator=(Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>&& x) noexcept(LeafTraits::propagate_on_container_move_assignment::value or LeafTraits::is_always_equal::value);
+	/**
+	* Comparision operator. Trees are equal if they have the same elements.
+	*/
+	bool operator==(const Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>& x) const;
+	/**
+	* Comparision operator.
+	*/
+	bool operator!=(const Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>& x) const;
+	/**
+	* Functionallity: Inserts the element to the B+ tree. Outputs false if the key is already in the tree.
+	* param[in] key : Key of the element that is going to be inserted.
+	* param[in] info : Info of the element that is going to be inserted.
+	*/
+	bool insert(const Key& key, const Info& info);
+	/**
+	* Functionallity: Same as insert, it outputs the iterator to the a new element or an iterator to existing element.
+	* param[in] key : Key of the element that is going to be inserted.
+	* param[in] info : Info of the element that is going to be inserted.
+	* param[in] it : A reference to iterator to which we want to provide information about the added/existing element.
+	*/
+	bool insert(const Key& key, const Info& info, iterator& it);
+	/**
+	* Functionallity: Inserts an element with Info constructed from args, only if the key is not in the tree yet.
+	* Outputs an iterator to the new/existing element and true if the element was inserted.
+	*/
+	template<typename... Args>
+	std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args);
+	/**
+	* Functionallity: Inserts the element or overwrites the info of an existing one.
+	* Outputs an iterator to the element and true if the element was inserted.
+	*/
+	template<typename I>
+	std::pair<iterator, bool> insert_or_assign(const Key& key, I&& info);
+	/**
+	* Functionallity: Finds or inserts (with a value initialized Info) the element and applies method to its info.
+	* Outputs an iterator to the element and true if the element was inserted.
+	*/
+	template<typename Update>
+	std::pair<iterator, bool> upsert(const Key& key, Update method);
+	/**
+	* Same as upsert, available with a transparent Compare. The key is built only when the element is inserted.
+	*/
+	template<typename K, typename Update, typename C = Compare, typename = typename C::is_transparent>
+	std::pair<iterator, bool> upsert(const K& key, Update method);
+	/**
+	* Functionality: Delete the element from the B+ tree. Outputs false if the key is not a member of the tree.
+	* Approche: A leaf which has less than Fanout / 2 elements borrows one from a sibling or is merged with it,
+	* the same is repeated for the inner nodes on the way up.
+	* param[in] key : Key of the element that is going to be deleted.
+	*/
+	bool remove(const Key& key);
+	/**
+	* Functionality: Executes set of instruction for all of the elements of the tree.
+	* param[in] method : Method accepting const_iterator.
+	* param[in] type : By default TravelType::Preorder. All of the types visit the elements in order.
+	*/
+	template<typename ToDo>
+	void executeForAllNodes(ToDo method, TravelType type = TravelType::Preorder) const;
+	/**
+	* Prints all of the elements, all of them are in order.
+	* param[in] out : By default std::cout. Specifies the ostream variable.
+	*/
+	void preorder(std::ostream& out = std::cout) const;
+	void inorder(std::ostream& out = std::cout) const;
+	void postorder(std::ostream& out = std::cout) const;
+	/**
+	* The method finds an element with a given key. If an element was not found the empty iterator is being returned.
+	* param[in] key : Key to find a value.
+	*/
+	iterator find(const Key& key) const;
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator find(const K& key) const;
+	/**
+	* Checks whether an element with a given key is a member of the tree.
+	*/
+	bool contains(const Key& key) const;
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	bool contains(const K& key) const;
+	/**
+	* Outputs an iterator to the first element which key is not less than a given key.
+	*/
+	iterator lower_bound(const Key& key) const;
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator lower_bound(const K& key) const;
+	/**
+	* Outputs an iterator to the first element which key is greater than a given key.
+	*/
+	iterator upper_bound(const Key& key) const;
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator upper_bound(const K& key) const;
+};
+/**
+* B+ tree dictionary with a given fanout.
+*/
+template<typename Key, typename Info, std::size_t Fanout = 64, typename Compare = std::less<Key>, typename Allocator = std::allocator<std::pair<const Key, Info>>>
+using BPlusDictionary = Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>;
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::Leaf* Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::createLeaf() {
+	Leaf* curr = LeafTraits::allocate(alloc, 1);
+	try {
+		LeafTraits::construct(alloc, curr);
+	}
+	catch (...) {
+		LeafTraits::deallocate(alloc, curr, 1);
+		throw;
+	}
+	return curr;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::Inner* Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::createInner() {
+	InnerAllocator innerAlloc(alloc);
+	Inner* curr = InnerTraits::allocate(innerAlloc, 1);
+	try {
+		InnerTraits::construct(innerAlloc, curr);
+	}
+	catch (...) {
+		InnerTraits::deallocate(innerAlloc, curr, 1);
+		throw;
+	}
+	return curr;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+void Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::destroyNode(NodeBase* curr) {
+	if (curr->leaf) {
+		Leaf* leaf = static_cast<Leaf*>(curr);
+		LeafTraits::destroy(alloc, leaf);
+		LeafTraits::deallocate(alloc, leaf, 1);
+	}
+	else {
+		InnerAllocator innerAlloc(alloc);
+		Inner* inner = static_cast<Inner*>(curr);
+		InnerTraits::destroy(innerAlloc, inner);
+		InnerTraits::deallocate(innerAlloc, inner, 1);
+	}
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+void Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::clear(NodeBase* curr) {
+	//the recursion is only as deep as the tree, which is a few levels
+	if (!curr->leaf) {
+		Inner* inner = static_cast<Inner*>(curr);
+		for (std::size_t i = 0; i < inner->count; i++)
+			clear(inner->children[i]);
+	}
+	destroyNode(curr);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::NodeBase* Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::copy(const NodeBase* curr, Leaf*& prevLeaf) {
+	if (curr->leaf) {
+		const Leaf* source = static_cast<const Leaf*>(curr);
+		Leaf* leaf = createLeaf();
+		try {
+			std::copy(source->keys, source->keys + source->count, leaf->keys);
+			std::copy(source->infos, source->infos + source->count, leaf->infos);
+		}
+		catch (...) {
+			destroyNode(leaf);
+			throw;
+		}
+		leaf->count = source->count;
+		leaf->prev = prevLeaf;
+		if (prevLeaf)
+			prevLeaf->next = leaf;
+		prevLeaf = leaf;
+		return leaf;
+	}
+	const Inner* source = static_cast<const Inner*>(curr);
+	Inner* inner = createInner();
+	try {
+		std::copy(source->keys, source->keys + source->count - 1, inner->keys);
+		for (; inner->count < source->count; inner->count++)
+			inner->children[inner->count] = copy(source->children[inner->count], prevLeaf);
+	}
+	catch (...) {
+		clear(inner);
+		throw;
+	}
+	return inner;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+template<typename K>
+std::size_t Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::childIndex(const Inner* curr, const K& key) const {
+	return DictionaryDetail::countNotGreater(curr->keys, curr->count - 1, key, comp, FastSearch<K>());
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+template<typename K>
+std::size_t Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::leafPosition(const Leaf* curr, const K& key) const {
+	return DictionaryDetail::countLess(curr->keys, curr->count, key, comp, FastSearch<K>());
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+template<typename K>
+typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::Leaf* Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::findLeaf(const K& key) const {
+	NodeBase* curr = head;
+	if (!curr)
+		return nullptr;
+	while (!curr->leaf) {
+		const Inner* inner = static_cast<const Inner*>(curr);
+		curr = inner->children[childIndex(inner, key)];
+	}
+	return static_cast<Leaf*>(curr);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+template<typename K, typename Make>
+bool Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::insert(const K& key, Leaf*& leaf, std::size_t& pos, Make make) {
+	Inner* path[MaxHeight];
+	std::size_t slots[MaxHeight];
+	int depth = 0;
+	NodeBase* curr = head;
+	if (curr) {
+		while (!curr->leaf) {
+			Inner* inner = static_cast<Inner*>(curr);
+			std::size_t i = childIndex(inner, key);
+			path[depth] = inner;
+			slots[depth++] = i;
+			curr = inner->children[i];
+		}
+		leaf = static_cast<Leaf*>(curr);
+		pos = leafPosition(leaf, key);
+		if (pos < leaf->count and !comp(key, leaf->keys[pos]))
+			return false;
+	}
+	//everything that can throw is done before the tree is changed
+	Key newKey(key);
+	Info newInfo(make());
+	if (!curr) {
+		head = first = last = leaf = createLeaf();
+		height = 1;
+		pos = 0;
+	}
+	//the leaf and every full inner node above it are split, if the root is split there is a new root
+	Leaf* spareLeaf = nullptr;
+	Inner* spares[MaxHeight + 1];
+	int needed = 0;
+	if (leaf->count == Fanout) {
+		int d = depth - 1;
+		while (d >= 0 and path[d]->count == Fanout)
+			d--;
+		needed = depth - 1 - d + (d < 0 ? 1 : 0);
+		int created = 0;
+		try {
+			spareLeaf = createLeaf();
+			for (; created < needed; created++)
+				spares[created] = createInner();
+		}
+		catch (...) {
+			if (spareLeaf)
+				destroyNode(spareLeaf);
+			for (int i = 0; i < created; i++)
+				destroyNode(spares[i]);
+			throw;
+		}
+	}
+	elements++;
+	if (!spareLeaf) {
+		for (std::size_t i = leaf->count; i > pos; i--) {
+			leaf->keys[i] = std::move(leaf->keys[i - 1]);
+			leaf->infos[i] = std::move(leaf->infos[i - 1]);
+		}
+		leaf->keys[pos] = std::move(newKey);
+		leaf->infos[pos] = std::move(newInfo);
+		leaf->count++;
+		return true;
+	}
+	//the leaf is split, the left one keeps half of the elements (including the new one)
+	Leaf* right = spareLeaf;
+	const std::size_t half = (Fanout + 1) / 2;
+	const std::size_t from = pos < half ? half - 1 : half;
+	for (std::size_t i = from; i < Fanout; i++) {
+		right->keys[i - from] = std::move(leaf->keys[i]);
+		right->infos[i - from] = std::move(leaf->infos[i]);
+	}
+	right->count = Fanout - from;
+	leaf->count = from;
+	Leaf* target = leaf;
+	if (pos >= half) {
+		target = right;
+		pos -= half;
+	}
+	for (std::size_t i = target->count; i > pos; i--) {
+		target->keys[i] = std::move(target->keys[i - 1]);
+		target->infos[i] = std::move(target->infos[i - 1]);
+	}
+	target->keys[pos] = std::move(newKey);
+	target->infos[pos] = std::move(newInfo);
+	target->count++;
+	right->next = leaf->next;
+	right->prev = leaf;
+	if (leaf->next)
+		leaf->next->prev = right;
+	else
+		last = right;
+	leaf->next = right;
+	leaf = target;
+	//the separator and the new node go up
+	Key separator(right->keys[0]);
+	NodeBase* node = right;
+	int spare = 0;
+	while (depth > 0) {
+		Inner* inner = path[--depth];
+		std::size_t i = slots[depth];
+		if (inner->count < Fanout) {
+			for (std::size_t j = inner->count - 1; j > i; j--) {
+				inner->keys[j] = std::move(inner->keys[j - 1]);
+				inner->children[j + 1] = inner->children[j];
+			}
+			inner->keys[i] = std::move(separator);
+			inner->children[i + 1] = node;
+			inner->count++;
+			return true;
+		}
+		//the inner node has Fanout + 1 children with the new one, it keeps the first half of them
+		//the element j of these arrays (with the new child i + 1 and the new key i) is given by:
+		auto keyAt = [&](std::size_t j)->Key& { return j < i ? inner->keys[j] : (j == i ? separator : inner->keys[j - 1]); };
+		auto childAt = [&](std::size_t j)->NodeBase* { return j <= i ? inner->children[j] : (j == i + 1 ? node : inner->children[j - 1]); };
+		Inner* sibling = spares[spare++];
+		for (std::size_t j = half; j <= Fanout; j++)
+			sibling->children[j - half] = childAt(j);
+		for (std::size_t j = half; j < Fanout; j++)
+			sibling->keys[j - half] = std::move(keyAt(j));
+		sibling->count = Fanout + 1 - half;
+		Key up(std::move(keyAt(half - 1)));
+		if (i + 1 < half) {
+			//the new child stays in this node
+			for (std::size_t j = half - 1; j > i + 1; j--)
+				inner->children[j] = inner->children[j - 1];
+			for (std::size_t j = half - 2; j > i; j--)
+				inner->keys[j] = std::move(inner->keys[j - 1]);
+			inner->keys[i] = std::move(separator);
+			inner->children[i + 1] = node;
+		}
+		inner->count = half;
+		separator = std::move(up);
+		node = sibling;
+	}
+	//the root was split
+	Inner* root = spares[spare];
+	root->children[0] = head;
+	root->children[1] = node;
+	root->keys[0] = std::move(separator);
+	root->count = 2;
+	head = root;
+	height++;
+	return true;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+void Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::removeChild(Inner* curr, std::size_t index) {
+	for (std::size_t j = index; j + 1 < curr->count; j++) {
+		curr->keys[j - 1] = std::move(curr->keys[j]);
+		curr->children[j] = curr->children[j + 1];
+	}
+	curr->count--;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+void Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::unlinkLeaf(Leaf* curr) {
+	if (curr->prev)
+		curr->prev->next = curr->next;
+	else
+		first = curr->next;
+	if (curr->next)
+		curr->next->prev = curr->prev;
+	else
+		last = curr->prev;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator::iterator(Leaf* x, std::size_t p, const Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>* m) : master(m), leaf(x), pos(p) {}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator::iterator() : master(nullptr), leaf(nullptr), pos(0) {}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+bool Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator::operator==(const iterator& x) const {
+	return leaf == x.leaf and pos == x.pos and master == x.master;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+bool Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator::operator!=(const iterator& x) const {
+	return !(*this == x);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+const typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator& Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator::operator++() const {
+	if (!master) {
+		throw "Master does not exist!";
+	}
+	//current is null
+	if (!leaf) {
+		if (!master->first) {
+			throw "Master is empty!";
+		}
+		leaf = master->first;
+		pos = 0;
+	}
+	else if (pos + 1 < leaf->count) {
+		pos++;
+	}
+	else {
+		leaf = leaf->next;
+		pos = 0;
+	}
+	return *this;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator::operator++(int) const {
+	iterator cache(*this);
+	operator++();
+	return cache;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+const typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator& Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator::operator--() const {
+	if (!master) {
+		throw "Master does not exist!";
+	}
+	//current is null
+	if (!leaf) {
+		if (!master->last) {
+			throw "Master is empty!";
+		}
+		leaf = master->last;
+		pos = leaf->count - 1;
+	}
+	else if (pos > 0) {
+		pos--;
+	}
+	else {
+		leaf = leaf->prev;
+		pos = leaf ? leaf->count - 1 : 0;
+	}
+	return *this;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator::operator--(int) const {
+	iterator cache(*this);
+	operator--();
+	return cache;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+const Info& Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator::operator*() const {
+	if (!leaf)
+		throw "Iterator does not have a value!";
+	return leaf->infos[pos];
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+Info& Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator::operator*() {
+	if (!leaf)
+		throw "Iterator does not have a value!";
+	return leaf->infos[pos];
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+const Key& Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator::getKey() const {
+	if (!leaf)
+		throw "Iterator does not have a value!";
+	return leaf->keys[pos];
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+const Info& Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator::getInfo() const {
+	if (!leaf)
+		throw "Iterator does not have a value!";
+	return leaf->infos[pos];
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+bool Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator::isNull() const {
+	return !leaf;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::reverse_iterator::reverse_iterator(Leaf* x, std::size_t p, const Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>* m) : iterator(x, p, m) {}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::reverse_iterator::reverse_iterator() : iterator() {}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+const typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::reverse_iterator& Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::reverse_iterator::operator++() const {
+	iterator::operator--();
+	return *this;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::reverse_iterator Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::reverse_iterator::operator++(int) const {
+	reverse_iterator cache(*this);
+	iterator::operator--();
+	return cache;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+const typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::reverse_iterator& Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::reverse_iterator::operator--() const {
+	iterator::operator++();
+	return *this;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::reverse_iterator Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::reverse_iterator::operator--(int) const {
+	reverse_iterator cache(*this);
+	iterator::operator++();
+	return cache;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::begin() const {
+	return iterator(first, 0, this);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::end() const {
+	return iterator(nullptr, 0, this);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::reverse_iterator Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::rbegin() const {
+	return reverse_iterator(last, last ? last->count - 1 : 0, this);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::reverse_iterator Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::rend() const {
+	return reverse_iterator(nullptr, 0, this);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::Dictionary() : head(nullptr), first(nullptr), last(nullptr), elements(0), height(0), alloc(Allocator()), comp()
+{}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::Dictionary(const Allocator& a) : head(nullptr), first(nullptr), last(nullptr), elements(0), height(0), alloc(a), comp()
+{}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::Dictionary(const Compare& c, const Allocator& a) : head(nullptr), first(nullptr), last(nullptr), elements(0), height(0), alloc(a), comp(c)
+{}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::Dictionary(const Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>& x) : head(nullptr), first(nullptr), last(nullptr), elements(0), height(0),
+	alloc(LeafTraits::select_on_container_copy_construction(x.alloc)), comp(x.comp)
+{
+	*this = x;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::Dictionary(Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>&& x) noexcept : head(x.head), first(x.first), last(x.last),
+	elements(x.elements), height(x.height), alloc(std::move(x.alloc)), comp(x.comp)
+{
+	x.head = x.first = x.last = nullptr;
+	x.elements = 0;
+	x.height = 0;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::~Dictionary() {
+	clear();
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+int Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::getHeight() const {
+	return height;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+std::size_t Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::size() const {
+	return elements;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+bool Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::empty() const {
+	return elements == 0;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+void Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::clear() {
+	if (head)
+		clear(head);
+	head = first = last = nullptr;
+	elements = 0;
+	height = 0;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>& Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::operator=(const Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>& x) {
+	if (this != &x) {
+		clear();
+		comp = x.comp;
+		if (x.head) {
+			Leaf* prevLeaf = nullptr;
+			head = copy(x.head, prevLeaf);
+			last = prevLeaf;
+			first = last;
+			while (first->prev)
+				first = first->prev;
+			elements = x.elements;
+			height = x.height;
+		}
+	}
+	return *this;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>& Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::operator=(Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>&& x)
+	noexcept(LeafTraits::propagate_on_container_move_assignment::value or LeafTraits::is_always_equal::value) {
+	if (this != &x) {
+		clear();
+		comp = x.comp;
+		if (LeafTraits::propagate_on_container_move_assignment::value) {
+			alloc = std::move(x.alloc);
+		}
+		else if (alloc != x.alloc) {
+			//we cannot take over the nodes of a different allocator, so they are copied
+			*this = static_cast<const Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>&>(x);
+			x.clear();
+			return *this;
+		}
+		head = x.head;
+		first = x.first;
+		last = x.last;
+		elements = x.elements;
+		height = x.height;
+		x.head = x.first = x.last = nullptr;
+		x.elements = 0;
+		x.height = 0;
+	}
+	return *this;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+bool Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::operator==(const Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>& x) const {
+	if (elements != x.elements)
+		return false;
+	iterator b = x.begin();
+	for (iterator a = begin(); a != end(); ++a, ++b) {
+		if (!(a.getKey() == b.getKey()) or !(a.getInfo() == b.getInfo()))
+			return false;
+	}
+	return true;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+bool Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::operator!=(const Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>& x) const {
+	return !(*this == x);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+bool Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::insert(const Key& key, const Info& info) {
+	Leaf* leaf = nullptr;
+	std::size_t pos = 0;
+	return insert(key, leaf, pos, [&]() { return info; });
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+bool Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::insert(const Key& key, const Info& info, iterator& it) {
+	Leaf* leaf = nullptr;
+	std::size_t pos = 0;
+	bool inserted = insert(key, leaf, pos, [&]() { return info; });
+	it = iterator(leaf, pos, this);
+	return inserted;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+template<typename... Args>
+std::pair<typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator, bool> Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::try_emplace(const Key& key, Args&&... args) {
+	Leaf* leaf = nullptr;
+	std::size_t pos = 0;
+	bool inserted = insert(key, leaf, pos, [&]() { return Info(std::forward<Args>(args)...); });
+	return std::pair<iterator, bool>(iterator(leaf, pos, this), inserted);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+template<typename I>
+std::pair<typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator, bool> Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::insert_or_assign(const Key& key, I&& info) {
+	Leaf* leaf = nullptr;
+	std::size_t pos = 0;
+	bool inserted = insert(key, leaf, pos, [&]() { return Info(std::forward<I>(info)); });
+	if (!inserted)
+		leaf->infos[pos] = std::forward<I>(info);
+	return std::pair<iterator, bool>(iterator(leaf, pos, this), inserted);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+template<typename Update>
+std::pair<typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator, bool> Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::upsert(const Key& key, Update method) {
+	Leaf* leaf = nullptr;
+	std::size_t pos = 0;
+	bool inserted = insert(key, leaf, pos, [&]() { return Info(); });
+	method(leaf->infos[pos]);
+	return std::pair<iterator, bool>(iterator(leaf, pos, this), inserted);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+template<typename K, typename Update, typename C, typename>
+std::pair<typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator, bool> Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::upsert(const K& key, Update method) {
+	Leaf* leaf = nullptr;
+	std::size_t pos = 0;
+	bool inserted = insert(key, leaf, pos, [&]() { return Info(); });
+	method(leaf->infos[pos]);
+	return std::pair<iterator, bool>(iterator(leaf, pos, this), inserted);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+bool Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::remove(const Key& key) {
+	Inner* path[MaxHeight];
+	std::size_t slots[MaxHeight];
+	int depth = 0;
+	NodeBase* curr = head;
+	if (!curr)
+		return false;
+	while (!curr->leaf) {
+		Inner* inner = static_cast<Inner*>(curr);
+		std::size_t i = childIndex(inner, key);
+		path[depth] = inner;
+		slots[depth++] = i;
+		curr = inner->children[i];
+	}
+	Leaf* leaf = static_cast<Leaf*>(curr);
+	std::size_t pos = leafPosition(leaf, key);
+	if (pos == leaf->count or comp(key, leaf->keys[pos]))
+		return false;
+	for (std::size_t i = pos; i + 1 < leaf->count; i++) {
+		leaf->keys[i] = std::move(leaf->keys[i + 1]);
+		leaf->infos[i] = std::move(leaf->infos[i + 1]);
+	}
+	leaf->count--;
+	elements--;
+	if (depth == 0) {
+		//the leaf is the root
+		if (leaf->count == 0)
+			clear();
+		return true;
+	}
+	if (leaf->count >= MinLeaf)
+		return true;
+	Inner* parent = path[depth - 1];
+	std::size_t i = slots[depth - 1];
+	Leaf* left = i > 0 ? static_cast<Leaf*>(parent->children[i - 1]) : nullptr;
+	Leaf* right = i + 1 < parent->count ? static_cast<Leaf*>(parent->children[i + 1]) : nullptr;
+	if (left and left->count > MinLeaf) {
+		//borrowing the biggest element of the left sibling
+		for (std::size_t j = leaf->count; j > 0; j--) {
+			leaf->keys[j] = std::move(leaf->keys[j - 1]);
+			leaf->infos[j] = std::move(leaf->infos[j - 1]);
+		}
+		left->count--;
+		leaf->keys[0] = std::move(left->keys[left->count]);
+		leaf->infos[0] = std::move(left->infos[left->count]);
+		leaf->count++;
+		parent->keys[i - 1] = leaf->keys[0];
+		return true;
+	}
+	if (right and right->count > MinLeaf) {
+		//borrowing the smallest element of the right sibling
+		leaf->keys[leaf->count] = std::move(right->keys[0]);
+		leaf->infos[leaf->count] = std::move(right->infos[0]);
+		leaf->count++;
+		for (std::size_t j = 0; j + 1 < right->count; j++) {
+			right->keys[j] = std::move(right->keys[j + 1]);
+			right->infos[j] = std::move(right->infos[j + 1]);
+		}
+		right->count--;
+		parent->keys[i] = right->keys[0];
+		return true;
+	}
+	//merging with a sibling, the right one of the two is deleted
+	if (!left) {
+		left = leaf;
+		leaf = right;
+		i++;
+	}
+	for (std::size_t j = 0; j < leaf->count; j++) {
+		left->keys[left->count + j] = std::move(leaf->keys[j]);
+		left->infos[left->count + j] = std::move(leaf->infos[j]);
+	}
+	left->count += leaf->count;
+	unlinkLeaf(leaf);
+	destroyNode(leaf);
+	removeChild(parent, i);
+	//the same for the inner nodes on the way up
+	for (int d = depth - 1; d >= 0; d--) {
+		Inner* inner = path[d];
+		if (d == 0) {
+			if (inner->count == 1) {
+				head = inner->children[0];
+				destroyNode(inner);
+				height--;
+			}
+			break;
+		}
+		if (inner->count >= MinInner)
+			break;
+		Inner* up = path[d - 1];
+		std::size_t k = slots[d - 1];
+		Inner* leftInner = k > 0 ? static_cast<Inner*>(up->children[k - 1]) : nullptr;
+		Inner* rightInner = k + 1 < up->count ? static_cast<Inner*>(up->children[k + 1]) : nullptr;
+		if (leftInner and leftInner->count > MinInner) {
+			for (std::size_t j = inner->count; j > 0; j--)
+				inner->children[j] = inner->children[j - 1];
+			for (std::size_t j = inner->count - 1; j > 0; j--)
+				inner->keys[j] = std::move(inner->keys[j - 1]);
+			inner->keys[0] = std::move(up->keys[k - 1]);
+			inner->children[0] = leftInner->children[leftInner->count - 1];
+			up->keys[k - 1] = std::move(leftInner->keys[leftInner->count - 2]);
+			leftInner->count--;
+			inner->count++;
+			break;
+		}
+		if (rightInner and rightInner->count > MinInner) {
+			inner->keys[inner->count - 1] = std::move(up->keys[k]);
+			inner->children[inner->count] = rightInner->children[0];
+			up->keys[k] = std::move(rightInner->keys[0]);
+			for (std::size_t j = 0; j + 1 < rightInner->count; j++) {
+				rightInner->children[j] = rightInner->children[j + 1];
+				if (j + 2 < rightInner->count)
+					rightInner->keys[j] = std::move(rightInner->keys[j + 1]);
+			}
+			rightInner->count--;
+			inner->count++;
+			break;
+		}
+		if (!leftInner) {
+			leftInner = inner;
+			inner = rightInner;
+			k++;
+		}
+		//the separator from the parent goes down between the two nodes
+		leftInner->keys[leftInner->count - 1] = std::move(up->keys[k - 1]);
+		for (std::size_t j = 0; j < inner->count; j++) {
+			leftInner->children[leftInner->count + j] = inner->children[j];
+			if (j + 1 < inner->count)
+				leftInner->keys[leftInner->count + j] = std::move(inner->keys[j]);
+		}
+		leftInner->count += inner->count;
+		destroyNode(inner);
+		removeChild(up, k);
+	}
+	return true;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+template<typename ToDo>
+void Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::executeForAllNodes(ToDo method, TravelType type) const {
+	(void)type;
+	for (Leaf* leaf = first; leaf; leaf = leaf->next)
+		for (std::size_t i = 0; i < leaf->count; i++)
+			method(const_iterator(leaf, i, this));
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+void Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::preorder(std::ostream& out) const {
+	executeForAllNodes(
+		[&out](const_iterator& curr)->void
+		{
+			out << "Key:" << curr.getKey() << ", info: " << curr.getInfo() << std::endl;
+		},
+		TravelType::Preorder);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+void Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::inorder(std::ostream& out) const {
+	executeForAllNodes(
+		[&out](const_iterator& curr)->void
+		{
+			out << "Key:" << curr.getKey() << ", info: " << curr.getInfo() << std::endl;
+		},
+		TravelType::Inorder);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+void Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::postorder(std::ostream& out) const {
+	executeForAllNodes(
+		[&out](const_iterator& curr)->void
+		{
+			out << "Key:" << curr.getKey() << ", info: " << curr.getInfo() << std::endl;
+		},
+		TravelType::Postorder);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+template<typename K>
+typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::Leaf* Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::search(const K& key, std::size_t& pos) const {
+	Leaf* leaf = findLeaf(key);
+	if (!leaf)
+		return nullptr;
+	pos = leafPosition(leaf, key);
+	if (pos == leaf->count or comp(key, leaf->keys[pos]))
+		return nullptr;
+	return leaf;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+template<typename K>
+typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::Leaf* Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::lowerBound(const K& key, std::size_t& pos) const {
+	Leaf* leaf = findLeaf(key);
+	if (!leaf)
+		return nullptr;
+	pos = leafPosition(leaf, key);
+	//all of the keys of the leaf are smaller, so it is the first element of the next leaf
+	if (pos == leaf->count) {
+		pos = 0;
+		return leaf->next;
+	}
+	return leaf;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+template<typename K>
+typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::Leaf* Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::upperBound(const K& key, std::size_t& pos) const {
+	Leaf* leaf = findLeaf(key);
+	if (!leaf)
+		return nullptr;
+	pos = DictionaryDetail::countNotGreater(leaf->keys, leaf->count, key, comp, FastSearch<K>());
+	if (pos == leaf->count) {
+		pos = 0;
+		return leaf->next;
+	}
+	return leaf;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::find(const Key& key) const {
+	std::size_t pos = 0;
+	Leaf* leaf = search(key, pos);
+	return leaf ? iterator(leaf, pos, this) : iterator();
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+template<typename K, typename C, typename>
+typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::find(const K& key) const {
+	std::size_t pos = 0;
+	Leaf* leaf = search(key, pos);
+	return leaf ? iterator(leaf, pos, this) : iterator();
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+bool Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::contains(const Key& key) const {
+	std::size_t pos = 0;
+	return search(key, pos) != nullptr;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+template<typename K, typename C, typename>
+bool Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::contains(const K& key) const {
+	std::size_t pos = 0;
+	return search(key, pos) != nullptr;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::lower_bound(const Key& key) const {
+	std::size_t pos = 0;
+	Leaf* leaf = lowerBound(key, pos);
+	return iterator(leaf, pos, this);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+template<typename K, typename C, typename>
+typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::lower_bound(const K& key) const {
+	std::size_t pos = 0;
+	Leaf* leaf = lowerBound(key, pos);
+	return iterator(leaf, pos, this);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::upper_bound(const Key& key) const {
+	std::size_t pos = 0;
+	Leaf* leaf = upperBound(key, pos);
+	return iterator(leaf, pos, this);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, std::size_t Fanout>
+template<typename K, typename C, typename>
+typename Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::iterator Dictionary<Key, Info, Compare, Allocator, BPlusTree<Fanout>>::upper_bound(const K& key) const {
+	std::size_t pos = 0;
+	Leaf* leaf = upperBound(key, pos);
+	return iterator(leaf, pos, this);
+}
@@ -0,0 +1,869 @@
+#pragma once
+#include<cstdint>
+#include<iostream>
+#include<utility>
+#include<vector>
+#include<algorithm>
+/**
+* \brief Compact version of the AVL Dictionary.
+* All of the nodes are kept in one contiguous vector and they are linked with 32-bit indices instead of pointers,
+* the height is stored in a single byte. Key and the links (which are used during the descent) are kept together,
+* infos are stored in a separate vector, so for Dictionary<int, int> a node is 20 bytes + 4 bytes of info
+* instead of a separate allocation of 48 bytes.
+* Removing an element moves the last node to the freed place, so the vector has no holes,
+* but iterators to the moved element are invalidated.
+* The public API (including iterators) is the same as the one of Dictionary.
+*/
+template<typename Key, typename Info>
+class CompactDictionary {
+public:
+	/**
+	* \brief Types of traversing the tree.
+	*/
+	enum class TravelType {
+		Preorder,
+		Inorder,
+		Postorder
+	};
+private:
+	typedef std::uint32_t Index;
+	/**
+	* Index used as a null pointer.
+	*/
+	static constexpr Index none = 0xFFFFFFFFu;
+	struct Node {
+		Key m_key;
+		Index left;
+		Index right;
+		Index up;
+		std::int8_t height;
+		template<typename K>
+		Node(K&& key) : m_key(std::forward<K>(key)), left(none), right(none), up(none), height(1) {}
+	};
+	std::vector<Node> nodes;
+	std::vector<Info> infos;
+	Index head;
+	/**
+	* Outputs the current height of a node.
+	*/
+	int getHeight(Index curr) const;
+	/**
+	* Outputs the calculated balance of a node. According to the left and right subtree.
+	*/
+	int getBalance(Index curr) const;
+	/**
+	* Recalculates height of a node from its children.
+	*/
+	void update(Index curr);
+	/**
+	* Outputs a node with the minimal value of the subtree.
+	*/
+	Index getMinimalValueNode(Index curr) const;
+	/**
+	* Outputs a node with the maximal value of the subtree.
+	*/
+	Index getMaximalValueNode(Index curr) const;
+	/**
+	* Left rotation, same as in Dictionary.
+	*/
+	void leftRotate(Index& A);
+	/**
+	* Right rotation, same as in Dictionary.
+	*/
+	void rightRotate(Index& A);
+	/**
+	* Outputs a reference to the index which holds the node: head or the left/right index of its parent.
+	* The reference is valid until the next insertion.
+	*/
+	Index& link(Index curr);
+	/**
+	* Updates the height of a node and performs the rotations if it is unbalanced. Outputs the new root of the subtree.
+	*/
+	Index rebalance(Index curr);
+	/**
+	* Goes up from curr and rebalances every node on the way, stops as soon as the height stops changing.
+	*/
+	void retrace(Index curr);
+	/**
+	* Inserts the node and balances the tree. The key and info are obtained from make() only when the key is not in the tree yet.
+	* Outputs false (and the existing node through newNode) when the key is already in the tree.
+	*/
+	template<typename Make>
+	bool insert(const Key& key, Index& newNode, Make make);
+	/**
+	* Finds the node with a given key or outputs none.
+	*/
+	Index search(const Key& key) const;
+	/**
+	* A universal method of traversing the tree.
+	*/
+	template<typename ToDo>
+	void uniTraversal(Index curr, ToDo method, const TravelType type) const;
+public:
+	/**
+	* Iterator of the compact AVL tree. Same as the iterator of Dictionary.
+	*/
+	class iterator {
+		friend CompactDictionary<Key, Info>;
+		const CompactDictionary<Key, Info>* master;
+		mutable Index curr;
+		iterator(Index x, const CompactDictionary<Key, Info>* m);
+	public:
+		iterator();
+		iterator(const iterator& x) = default;
+		~iterator() = default;
+
+		iterator& operator=(const iterator& x) = default;
+
+		bool operator==(const iterator& x) const;
+
+		bool operator!=(const iterator& x) const;
+
+		const iterator& operator++() const;
+
+		iterator operator++(int) const;
+
+		const iterator& operator--() const;
+
+		iterator operator--(int) const;
+
+		const Info& operator*() const;
+
+		Info& operator*();
+
+		const Key& getKey() const;
+
+		const Info& getInfo() const;
+
+		bool isNull() const;
+
+		friend std::ostream& operator<<(std::ostream& out, const iterator& it) {
+			if (it.isNull()) {
+				out << "Key: " << " - " << ", info: " << " - ";
+			}
+			else {
+				out << "Key: " << it.getKey() << ", info: " << it.getInfo();
+			}
+			return out;
+		}
+	};
+	/**
+	* Reverse iterator of the compact AVL tree.
+	*/
+	class reverse_iterator : public iterator {
+		friend CompactDictionary<Key, Info>;
+		reverse_iterator(Index x, const CompactDictionary<Key, Info>* m);
+	public:
+		reverse_iterator();
+
+		reverse_iterator(const reverse_iterator& x) = default;
+
+		~reverse_iterator() = default;
+
+		reverse_iterator& operator=(const reverse_iterator& x) = default;
+
+		const reverse_iterator& operator++() const;
+
+		reverse_iterator operator++(int) const;
+
+		const reverse_iterator& operator--() const;
+
+		reverse_iterator operator--(int) const;
+	};
+	typedef const iterator const_iterator;
+	typedef const reverse_iterator const_reverse_iterator;
+	/**
+	* An iterator to the smalles element of the tree. O(logN).
+	*/
+	iterator begin() const;
+	/**
+	* An iterator to the end.
+	*/
+	iterator end() const;
+	/**
+	* An reverese iterator to the biggest element of the tree. O(logN).
+	*/
+	reverse_iterator rbegin() const;
+	/**
+	* An iterator to the end.
+	*/
+	reverse_iterator rend() const;
+	/**
+	* Constructor creates an empty tree.
+	*/
+	CompactDictionary();
+	/**
+	* Outputs the height of a tree. O(1).
+	*/
+	int getHeight() const;
+	/**
+	* Outputs the number of elements. O(1).
+	*/
+	std::size_t size() const;
+	/**
+	* Checks whether the tree is empty.
+	*/
+	bool empty() const;
+	/**
+	* Deletes all of the elements from the tree.
+	*/
+	void clear();
+	/**
+	* Reserves the place for count elements, so the vectors are not reallocated.
+	*/
+	void reserve(std::size_t count);
+	/**
+	* Comparision operator.
+	*/
+	bool operator==(const CompactDictionary<Key, Info>& x) const;
+	/**
+	* Comparision operator.
+	*/
+	bool operator!=(const CompactDictionary<Key, Info>& x) const;
+	/**
+	* Functionallity: Inserts the node to the AVL tree. Outputs false if the key is already in the tree.
+	* param[in] key : Key of the element that is going to be inserted.
+	* param[in] info : Info of the element that is going to be inserted.
+	*/
+	bool insert(const Key& key, const Info& info);
+	/**
+	* Functionallity: Same as insert, it outputs the iterator to the a new element or an iterator to existing element.
+	* param[in] key : Key of the element that is going to be inserted.
+	* param[in] info : Info of the element that is going to be inserted.
+	* param[in] it : A reference to iterator to which we want to provide information about the added/existing element.
+	*/
+	bool insert(const Key& key, const Info& info, iterator& it);
+	/**
+	* Functionallity: Inserts an element with Info constructed from args, only if the key is not in the tree yet.
+	* Outputs an iterator to the new/existing element and true if the element was inserted.
+	*/
+	template<typename... Args>
+	std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args);
+	/**
+	* Functionallity: Finds or inserts (with a value initialized Info) the element and applies method to its info.
+	* Outputs an iterator to the element and true if the element was inserted.
+	*/
+	template<typename Update>
+	std::pair<iterator, bool> upsert(const Key& key, Update method);
+	/**
+	* Functionality: Delete the node from the AVL tree. Outputs false if the key is not a member of the tree.
+	* The last node of the vector is moved to the freed place.
+	* param[in] key : Key of the element that is going to be deleted.
+	*/
+	bool remove(const Key& key);
+	/**
+	* Functionality: Executes set of instruction for all of the nodes of the AVL tree, same as in Dictionary.
+	* param[in] method : Method accepting const_iterator.
+	* param[in] type : By default TravelType::Preorder. Specifies the type of traversing.
+	*/
+	template<typename ToDo>
+	void executeForAllNodes(ToDo method, TravelType type = TravelType::Preorder) const;
+	/**
+	* Classic BST traversals.
+	* param[in] out : By default std::cout. Specifies the ostream variable.
+	*/
+	void preorder(std::ostream& out = std::cout) const;
+	void inorder(std::ostream& out = std::cout) const;
+	void postorder(std::ostream& out = std::cout) const;
+	/**
+	* The method finds an element with a given key. If an element was not found the empty iterator is being returned.
+	* param[in] key : Key to find a value.
+	*/
+	iterator find(const Key& key) const;
+	/**
+	* Checks whether an element with a given key is a member of the tree.
+	*/
+	bool contains(const Key& key) const;
+	/**
+	* Outputs an iterator to the first element which key is not less than a given key.
+	*/
+	iterator lower_bound(const Key& key) const;
+	/**
+	* Outputs an iterator to the first element which key is greater than a given key.
+	*/
+	iterator upper_bound(const Key& key) const;
+};
+
+template<typename Key, typename Info>
+int CompactDictionary<Key, Info>::getHeight(Index curr) const {
+	if (curr != none)
+		return nodes[curr].height;
+	else
+		return 0;
+}
+
+template<typename Key, typename Info>
+int CompactDictionary<Key, Info>::getBalance(Index curr) const {
+	if (curr != none)
+		return getHeight(nodes[curr].left) - getHeight(nodes[curr].right);
+	else
+		return 0;
+}
+
+template<typename Key, typename Info>
+void CompactDictionary<Key, Info>::update(Index curr) {
+	nodes[curr].height = static_cast<std::int8_t>(std::max(getHeight(nodes[curr].left), getHeight(nodes[curr].right)) + 1);
+}
+
+template<typename Key, typename Info>
+typename CompactDictionary<Key, Info>::Index CompactDictionary<Key, Info>::getMinimalValueNode(Index curr) const {
+	if (curr != none)
+		while (nodes[curr].left != none)
+			curr = nodes[curr].left;
+	return curr;
+}
+
+template<typename Key, typename Info>
+typename CompactDictionary<Key, Info>::Index CompactDictionary<Key, Info>::getMaximalValueNode(Index curr) const {
+	if (curr != none)
+		while (nodes[curr].right != none)
+			curr = nodes[curr].right;
+	return curr;
+}
+
+template<typename Key, typename Info>
+void CompactDictionary<Key, Info>::leftRotate(Index& A) {
+	Index B = nodes[A].right;
+	Index x1 = nodes[B].left;
+	//rotation
+	nodes[B].up = nodes[A].up;
+	nodes[B].left = A;
+	nodes[A].up = B;
+	nodes[A].right = x1;
+	if (x1 != none)
+		nodes[x1].up = A;
+	//new heights
+	update(A);
+	update(B);
+	//update the A
+	A = B;
+}
+
+template<typename Key, typename Info>
+void CompactDictionary<Key, Info>::rightRotate(Index& A) {
+	Index B = nodes[A].left;
+	Index x1 = nodes[B].right;
+	//rotation
+	nodes[B].right = A;
+	nodes[B].up = nodes[A].up;
+	nodes[A].up = B;
+	nodes[A].left = x1;
+	if (x1 != none)
+		nodes[x1].up = A;
+	//new heights
+	update(A);
+	update(B);
+	//update the A
+	A = B;
+}
+
+template<typename Key, typename Info>
+typename CompactDictionary<Key, Info>::Index& CompactDictionary<Key, Info>::link(Index curr) {
+	Index parent = nodes[curr].up;
+	if (parent == none)
+		return head;
+	if (nodes[parent].left == curr)
+		return nodes[parent].left;
+	return nodes[parent].right;
+}
+
+template<typename Key, typename Info>
+typename CompactDictionary<Key, Info>::Index CompactDictionary<Key, Info>::rebalance(Index curr) {
+	update(curr);
+	int balance = getBalance(curr);
+	if (balance > 1 and getBalance(nodes[curr].left) >= 0) {
+		//left-left case
+		rightRotate(curr);
+	}
+	else if (balance > 1 and getBalance(nodes[curr].left) < 0) {
+		//left-right case
+		leftRotate(nodes[curr].left);
+		rightRotate(curr);
+	}
+	else if (balance < -1 and getBalance(nodes[curr].right) <= 0) {
+		//right-right case
+		leftRotate(curr);
+	}
+	else if (balance < -1 and getBalance(nodes[curr].right) > 0) {
+		//right-left case
+		rightRotate(nodes[curr].right);
+		leftRotate(curr);
+	}
+	return curr;
+}
+
+template<typename Key, typename Info>
+void CompactDictionary<Key, Info>::retrace(Index curr) {
+	while (curr != none) {
+		int height = nodes[curr].height;
+		Index& parentLink = link(curr);
+		parentLink = rebalance(curr);
+		if (nodes[parentLink].height == height)
+			return;
+		curr = nodes[parentLink].up;
+	}
+}
+
+template<typename Key, typename Info>
+template<typename Make>
+bool CompactDictionary<Key, Info>::insert(const Key& key, Index& newNode, Make make) {
+	Index parent = none;
+	Index curr = head;
+	bool left = false;
+	while (curr != none) {
+		parent = curr;
+		if (key < nodes[curr].m_key) {
+			curr = nodes[curr].left;
+			left = true;
+		}
+		else if (nodes[curr].m_key < key) {
+			curr = nodes[curr].right;
+			left = false;
+		}
+		else {
+			newNode = curr;
+			return false;
+		}
+	}
+	if (nodes.size() >= none)
+		throw "Too many elements!";
+	//new node is always the last one
+	newNode = static_cast<Index>(nodes.size());
+	make();
+	nodes.back().up = parent;
+	if (parent == none)
+		head = newNode;
+	else if (left)
+		nodes[parent].left = newNode;
+	else
+		nodes[parent].right = newNode;
+	retrace(parent);
+	return true;
+}
+
+template<typename Key, typename Info>
+typename CompactDictionary<Key, Info>::Index CompactDictionary<Key, Info>::search(const Key& key) const {
+	Index curr = head;
+	while (curr != none) {
+		if (key < nodes[curr].m_key)
+			curr = nodes[curr].left;
+		else if (nodes[curr].m_key < key)
+			curr = nodes[curr].right;
+		else
+			return curr;
+	}
+	return none;
+}
+
+template<typename Key, typename Info>
+template<typename ToDo>
+void CompactDictionary<Key, Info>::uniTraversal(Index curr, ToDo method, const TravelType type) const {
+	if (curr != none) {
+		if (type == TravelType::Preorder) {
+			method(const_iterator(curr, this));
+		}
+		uniTraversal(nodes[curr].left, method, type);
+		if (type == TravelType::Inorder) {
+			method(const_iterator(curr, this));
+		}
+		uniTraversal(nodes[curr].right, method, type);
+		if (type == TravelType::Postorder) {
+			method(const_iterator(curr, this));
+		}
+	}
+}
+
+template<typename Key, typename Info>
+CompactDictionary<Key, Info>::iterator::iterator(Index x, const CompactDictionary<Key, Info>* m) : master(m), curr(x) {}
+
+template<typename Key, typename Info>
+CompactDictionary<Key, Info>::iterator::iterator() : master(nullptr), curr(none) {}
+
+template<typename Key, typename Info>
+bool CompactDictionary<Key, Info>::iterator::operator==(const iterator& x) const {
+	return curr == x.curr and master == x.master;
+}
+
+template<typename Key, typename Info>
+bool CompactDictionary<Key, Info>::iterator::operator!=(const iterator& x) const {
+	return curr != x.curr or master != x.master;
+}
+
+template<typename Key, typename Info>
+const typename CompactDictionary<Key, Info>::iterator& CompactDictionary<Key, Info>::iterator::operator++() const {
+	if (!master) {
+		throw "Master does not exist!";
+	}
+	const std::vector<Node>& nodes = master->nodes;
+	//current is null
+	if (curr == none) {
+		if (master->head == none) {
+			throw "Master is empty!";
+		}
+		curr = master->getMinimalValueNode(master->head);
+	}
+	else if (nodes[curr].right != none) {
+		curr = master->getMinimalValueNode(nodes[curr].right);
+	}
+	else {
+		Index prev = nodes[curr].up;
+		while (prev != none and curr == nodes[prev].right) {
+			curr = prev;
+			prev = nodes[prev].up;
+		}
+		curr = prev;
+	}
+	return *this;
+}
+
+template<typename Key, typename Info>
+typename CompactDictionary<Key, Info>::iterator CompactDictionary<Key, Info>::iterator::operator++(int) const {
+	iterator cache(*this);
+	operator++();
+	return cache;
+}
+
+template<typename Key, typename Info>
+const typename CompactDictionary<Key, Info>::iterator& CompactDictionary<Key, Info>::iterator::operator--() const {
+	if (!master) {
+		throw "Master does not exist!";
+	}
+	const std::vector<Node>& nodes = master->nodes;
+	//current is null
+	if (curr == none) {
+		if (master->head == none) {
+			throw "Master is empty!";
+		}
+		curr = master->getMaximalValueNode(master->head);
+	}
+	else if (nodes[curr].left != none) {
+		curr = master->getMaximalValueNode(nodes[curr].left);
+	}
+	else {
+		Index prev = nodes[curr].up;
+		while (prev != none and curr == nodes[prev].left) {
+			curr = prev;
+			prev = nodes[prev].up;
+		}
+		curr = prev;
+	}
+	return *this;
+}
+
+template<typename Key, typename Info>
+typename CompactDictionary<Key, Info>::iterator CompactDictionary<Key, Info>::iterator::operator--(int) const {
+	iterator cache(*this);
+	operator--();
+	return cache;
+}
+
+template<typename Key, typename Info>
+const Info& CompactDictionary<Key, Info>::iterator::operator*() const {
+	if (curr == none)
+		throw "Iterator does not have a value!";
+	return master->infos[curr];
+}
+
+template<typename Key, typename Info>
+Info& CompactDictionary<Key, Info>::iterator::operator*() {
+	if (curr == none)
+		throw "Iterator does not have a value!";
+	//the same trick as in Dictionary, the iterator can modify the info of a tree
+	return const_cast<CompactDictionary<Key, Info>*>(master)->infos[curr];
+}
+
+template<typename Key, typename Info>
+const Key& CompactDictionary<Key, Info>::iterator::getKey() const {
+	if (curr == none)
+		throw "Iterator does not have a value!";
+	return master->nodes[curr].m_key;
+}
+
+template<typename Key, typename Info>
+const Info& CompactDictionary<Key, Info>::iterator::getInfo() const {
+	if (curr == none)
+		throw "Iterator does not have a value!";
+	return master->infos[curr];
+}
+
+template<typename Key, typename Info>
+bool CompactDictionary<Key, Info>::iterator::isNull() const {
+	return curr == none;
+}
+
+template<typename Key, typename Info>
+CompactDictionary<Key, Info>::reverse_iterator::reverse_iterator(Index x, const CompactDictionary<Key, Info>* m) : iterator(x, m) {}
+
+template<typename Key, typename Info>
+CompactDictionary<Key, Info>::reverse_iterator::reverse_iterator() : iterator() {}
+
+template<typename Key, typename Info>
+const typename CompactDictionary<Key, Info>::reverse_iterator& CompactDictionary<Key, Info>::reverse_iterator::operator++() const {
+	iterator::operator--();
+	return *this;
+}
+
+template<typename Key, typename Info>
+typename CompactDictionary<Key, Info>::reverse_iterator CompactDictionary<Key, Info>::reverse_iterator::operator++(int) const {
+	reverse_iterator cache(*this);
+	iterator::operator--();
+	return cache;
+}
+
+template<typename Key, typename Info>
+const typename CompactDictionary<Key, Info>::reverse_iterator& CompactDictionary<Key, Info>::reverse_iterator::operator--() const {
+	iterator::operator++();
+	return *this;
+}
+
+template<typename Key, typename Info>
+typename CompactDictionary<Key, Info>::reverse_iterator CompactDictionary<Key, Info>::reverse_iterator::operator--(int) const {
+	reverse_iterator cache(*this);
+	iterator::operator++();
+	return cache;
+}
+
+template<typename Key, typename Info>
+typename CompactDictionary<Key, Info>::iterator CompactDictionary<Key, Info>::begin() const {
+	return iterator(getMinimalValueNode(head), this);
+}
+
+template<typename Key, typename Info>
+typename CompactDictionary<Key, Info>::iterator CompactDictionary<Key, Info>::end() const {
+	return iterator(none, this);
+}
+
+template<typename Key, typename Info>
+typename CompactDictionary<Key, Info>::reverse_iterator CompactDictionary<Key, Info>::rbegin() const {
+	return reverse_iterator(getMaximalValueNode(head), this);
+}
+
+template<typename Key, typename Info>
+typename CompactDictionary<Key, Info>::reverse_iterator CompactDictionary<Key, Info>::rend() const {
+	return reverse_iterator(none, this);
+}
+
+template<typename Key, typename Info>
+CompactDictionary<Key, Info>::CompactDictionary() : head(none)
+{}
+
+template<typename Key, typename Info>
+int CompactDictionary<Key, Info>::getHeight() const {
+	return getHeight(head);
+}
+
+template<typename Key, typename Info>
+std::size_t CompactDictionary<Key, Info>::size() const {
+	return nodes.size();
+}
+
+template<typename Key, typename Info>
+bool CompactDictionary<Key, Info>::empty() const {
+	return head == none;
+}
+
+template<typename Key, typename Info>
+void CompactDictionary<Key, Info>::clear() {
+	nodes.clear();
+	infos.clear();
+	head = none;
+}
+
+template<typename Key, typename Info>
+void CompactDictionary<Key, Info>::reserve(std::size_t count) {
+	nodes.reserve(count);
+	infos.reserve(count);
+}
+
+template<typename Key, typename Info>
+bool CompactDictionary<Key, Info>::operator==(const CompactDictionary<Key, Info>& x) const {
+	//same as Dictionary, the trees are equal if they have the same shape and elements
+	if (size() != x.size())
+		return false;
+	iterator a = begin();
+	iterator b = x.begin();
+	for (; a != end(); ++a, ++b) {
+		if (!(a.getKey() == b.getKey()) or !(a.getInfo() == b.getInfo()) or nodes[a.curr].height != x.nodes[b.curr].height)
+			return false;
+	}
+	return true;
+}
+
+template<typename Key, typename Info>
+bool CompactDictionary<Key, Info>::operator!=(const CompactDictionary<Key, Info>& x) const {
+	return !(*this == x);
+}
+
+template<typename Key, typename Info>
+bool CompactDictionary<Key, Info>::insert(const Key& key, const Info& info) {
+	Index node;
+	return insert(key, node, [&]() {
+		nodes.emplace_back(key);
+		infos.push_back(info);
+	});
+}
+
+template<typename Key, typename Info>
+bool CompactDictionary<Key, Info>::insert(const Key& key, const Info& info, iterator& it) {
+	Index node = none;
+	bool inserted = insert(key, node, [&]() {
+		nodes.emplace_back(key);
+		infos.push_back(info);
+	});
+	it = iterator(node, this);
+	return inserted;
+}
+
+template<typename Key, typename Info>
+template<typename... Args>
+std::pair<typename CompactDictionary<Key, Info>::iterator, bool> CompactDictionary<Key, Info>::try_emplace(const Key& key, Args&&... args) {
+	Index node = none;
+	bool inserted = insert(key, node, [&]() {
+		nodes.emplace_back(key);
+		infos.emplace_back(std::forward<Args>(args)...);
+	});
+	return std::pair<iterator, bool>(iterator(node, this), inserted);
+}
+
+template<typename Key, typename Info>
+template<typename Update>
+std::pair<typename CompactDictionary<Key, Info>::iterator, bool> CompactDictionary<Key, Info>::upsert(const Key& key, Update method) {
+	Index node = none;
+	bool inserted = insert(key, node, [&]() {
+		nodes.emplace_back(key);
+		infos.emplace_back();
+	});
+	method(infos[node]);
+	return std::pair<iterator, bool>(iterator(node, this), inserted);
+}
+
+template<typename Key, typename Info>
+bool CompactDictionary<Key, Info>::remove(const Key& key) {
+	Index curr = search(key);
+	if (curr == none)
+		return false;
+	//firstly the node is unlinked exactly as in Dictionary
+	Index changed = none;
+	if (nodes[curr].left == none or nodes[curr].right == none) {
+		Index cache = nodes[curr].left != none ? nodes[curr].left : nodes[curr].right;
+		if (cache != none)
+			nodes[cache].up = nodes[curr].up;
+		changed = nodes[curr].up;
+		link(curr) = cache;
+	}
+	else {
+		Index cache = getMinimalValueNode(nodes[curr].right);
+		if (nodes[cache].up == curr) {
+			changed = cache;
+		}
+		else {
+			changed = nodes[cache].up;
+			nodes[changed].left = nodes[cache].right;
+			if (nodes[cache].right != none)
+				nodes[nodes[cache].right].up = changed;
+			nodes[cache].right = nodes[curr].right;
+			nodes[nodes[cache].right].up = cache;
+		}
+		nodes[cache].left = nodes[curr].left;
+		nodes[nodes[cache].left].up = cache;
+		nodes[cache].up = nodes[curr].up;
+		nodes[cache].height = nodes[curr].height;
+		link(curr) = cache;
+	}
+	retrace(changed);
+	//then the last node takes the place of the removed one, so the vector stays contiguous
+	Index last = static_cast<Index>(nodes.size() - 1);
+	if (curr != last) {
+		link(last) = curr;
+		nodes[curr] = std::move(nodes[last]);
+		infos[curr] = std::move(infos[last]);
+		if (nodes[curr].left != none)
+			nodes[nodes[curr].left].up = curr;
+		if (nodes[curr].right != none)
+			nodes[nodes[curr].right].up = curr;
+	}
+	nodes.pop_back();
+	infos.pop_back();
+	return true;
+}
+
+template<typename Key, typename Info>
+template<typename ToDo>
+void CompactDictionary<Key, Info>::executeForAllNodes(ToDo method, TravelType type) const {
+	uniTraversal(head, method, type);
+}
+
+template<typename Key, typename Info>
+void CompactDictionary<Key, Info>::preorder(std::ostream& out) const {
+	uniTraversal(head,
+		[&out](const_iterator& curr)->void
+		{
+			out << "Key:" << curr.getKey() << ", info: " << curr.getInfo() << std::endl;
+		},
+		TravelType::Preorder);
+}
+
+template<typename Key, typename Info>
+void CompactDictionary<Key, Info>::inorder(std::ostream& out) const {
+	uniTraversal(head,
+		[&out](const_iterator& curr)->void
+		{
+			out << "Key:" << curr.getKey() << ", info: " << curr.getInfo() << std::endl;
+		},
+		TravelType::Inorder);
+}
+
+template<typename Key, typename Info>
+void CompactDictionary<Key, Info>::postorder(std::ostream& out) const {
+	uniTraversal(head,
+		[&out](const_iterator& curr)->void
+		{
+			out << "Key:" << curr.getKey() << ", info: " << curr.getInfo() << std::endl;
+		},
+		TravelType::Postorder);
+}
+
+template<typename Key, typename Info>
+typename CompactDictionary<Key, Info>::iterator CompactDictionary<Key, Info>::find(const Key& key) const {
+	Index curr = search(key);
+	if (curr == none)
+		return iterator();
+	return iterator(curr, this);
+}
+
+template<typename Key, typename Info>
+bool CompactDictionary<Key, Info>::contains(const Key& key) const {
+	return search(key) != none;
+}
+
+template<typename Key, typename Info>
+typename CompactDictionary<Key, Info>::iterator CompactDictionary<Key, Info>::lower_bound(const Key& key) const {
+	Index curr = head;
+	Index result = none;
+	while (curr != none) {
+		if (!(nodes[curr].m_key < key)) {
+			result = curr;
+			curr = nodes[curr].left;
+		}
+		else {
+			curr = nodes[curr].right;
+		}
+	}
+	return iterator(result, this);
+}
+
+template<typename Key, typename Info>
+typename CompactDictionary<Key, Info>::iterator CompactDictionary<Key, Info>::upper_bound(const Key& key) const {
+	Index curr = head;
+	Index result = none;
+	while (curr != none) {
+		if (key < nodes[curr].m_key) {
+			result = curr;
+			curr = nodes[curr].left;
+		}
+		else {
+			curr = nodes[curr].right;
+		}
+	}
+	return iterator(result, this);
+}
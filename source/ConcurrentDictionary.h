@@ -0,0 +1,858 @@
+#pragma once
+#include<atomic>
+#include<cstdint>
+#include<functional>
+#include<mutex>
+#include<thread>
+#include<utility>
+#include<vector>
+#include<algorithm>
+#include"Dictionary.h"
+namespace ConcurrentDictionaryDetail {
+	/**
+	* Lock of a single node. Writers keep it only for a few pointer updates, so spinning is cheaper than a mutex.
+	*/
+	class SpinLock {
+		std::atomic<bool> locked;
+	public:
+		SpinLock() : locked(false) {}
+		void lock() {
+			while (locked.exchange(true, std::memory_order_acquire)) {
+				while (locked.load(std::memory_order_relaxed))
+					std::this_thread::yield();
+			}
+		}
+		void unlock() {
+			locked.store(false, std::memory_order_release);
+		}
+	};
+	/**
+	* Epoch based reclamation of the unlinked nodes.
+	* Every operation is done inside of a Guard which announces the global epoch in one of the slots. A node unlinked
+	* in epoch e is freed when the global epoch reaches e + 2: the epoch is moved on only when all of the announced
+	* epochs are equal to it, so no thread which could have seen the node is still running.
+	*/
+	template<typename Node>
+	class Epochs {
+		static constexpr std::size_t Slots = 128;
+		//number of retired nodes after which the epoch is moved on and the old nodes are freed
+		static constexpr std::size_t Batch = 64;
+		struct alignas(64) Slot {
+			std::atomic<bool> used;
+			std::atomic<std::uint64_t> epoch;
+			Slot() : used(false), epoch(0) {}
+		};
+		Slot slots[Slots];
+		std::atomic<std::uint64_t> global;
+		std::mutex mutex;
+		//retired nodes with the epoch of the retirement, the epochs are not decreasing
+		std::vector<std::pair<std::uint64_t, Node*>> limbo;
+		/**
+		* Takes a free slot (the slots are not bound to the threads, so any number of threads can use the dictionary)
+		* and announces the current epoch in it.
+		*/
+		Slot& enter() {
+			static thread_local std::size_t hint = std::hash<std::thread::id>()(std::this_thread::get_id());
+			std::size_t i = hint % Slots;
+			for (std::size_t tries = 1; slots[i].used.load(std::memory_order_relaxed) or slots[i].used.exchange(true); ++tries) {
+				i = (i + 1) % Slots;
+				if (tries % Slots == 0)
+					std::this_thread::yield();
+			}
+			hint = i;
+			Slot& slot = slots[i];
+			//the epoch may be moved on between the load and the store, then the new one is announced
+			std::uint64_t current = global.load();
+			while (true) {
+				slot.epoch.store(current);
+				std::uint64_t again = global.load();
+				if (again == current)
+					break;
+				current = again;
+			}
+			return slot;
+		}
+		/**
+		* Moves the global epoch on if every thread inside of a Guard has announced the current one.
+		*/
+		void advance() {
+			std::uint64_t current = global.load();
+			for (Slot& slot : slots) {
+				if (slot.used.load() and slot.epoch.load() != current)
+					return;
+			}
+			global.compare_exchange_strong(current, current + 1);
+		}
+	public:
+		Epochs() : global(2) {}
+		Epochs(const Epochs& x) = delete;
+		Epochs& operator=(const Epochs& x) = delete;
+		~Epochs() {
+			for (std::pair<std::uint64_t, Node*>& retired : limbo)
+				delete retired.second;
+		}
+		/**
+		* Marks the critical section of an operation, nodes which are seen inside of it are not freed until it ends.
+		*/
+		class Guard {
+			Slot& slot;
+		public:
+			explicit Guard(Epochs& epochs) : slot(epochs.enter()) {}
+			Guard(const Guard& x) = delete;
+			Guard& operator=(const Guard& x) = delete;
+			~Guard() {
+				slot.used.store(false);
+			}
+		};
+		/**
+		* Hands over an unlinked node, it is deleted when no thread can be reading it anymore.
+		*/
+		void retire(Node* node) {
+			std::vector<Node*> ready;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				limbo.emplace_back(global.load(), node);
+				if (limbo.size() < Batch)
+					return;
+				advance();
+				std::uint64_t current = global.load();
+				auto last = std::find_if(limbo.begin(), limbo.end(),
+					[current](const std::pair<std::uint64_t, Node*>& retired) { return retired.first + 2 > current; });
+				for (auto it = limbo.begin(); it != last; ++it)
+					ready.push_back(it->second);
+				limbo.erase(limbo.begin(), last);
+			}
+			for (Node* x : ready)
+				delete x;
+		}
+	};
+}
+/**
+* \brief Thread-safe AVL dictionary.
+* Lookups go down without taking any lock. Every node has a version which is changed by a rotation that moves the node down,
+* a thread validates the version of the node after reading its link and goes one level back when it has changed
+* (optimistic hand-over-hand validation, the concurrent AVL tree of Bronson et al.).
+* Writers lock only the nodes which are relinked: the parent and the node for an insertion or removal,
+* additionally one or two children of the node for a rotation.
+* Removing a node with two children only marks it as removed, it stays in the tree as a routing node until
+* it has at most one child and can be unlinked. Unlinked nodes are freed with epochs (ConcurrentDictionaryDetail::Epochs).
+* An info is read and written under the lock of its node, so find copies it and the method of upsert should be short.
+*/
+template<typename Key, typename Info, typename Compare = std::less<Key>>
+class ConcurrentDictionary {
+	struct Node;
+	struct NodeBase {
+		std::atomic<Node*> left;
+		std::atomic<Node*> right;
+		std::atomic<NodeBase*> up;
+		//Unlinked or a counter of the rotations which moved the node down, Shrinking is set during such a rotation
+		std::atomic<std::uint64_t> version;
+		std::atomic<int> height;
+		ConcurrentDictionaryDetail::SpinLock lock;
+		NodeBase(NodeBase* parent, int h) : left(nullptr), right(nullptr), up(parent), version(0), height(h) {}
+		/**
+		* Left link for a negative direction, right link otherwise.
+		*/
+		std::atomic<Node*>& child(int dir) {
+			return dir < 0 ? left : right;
+		}
+	};
+	struct Node : NodeBase {
+		const Key m_key;
+		Info m_info;
+		//false when the element was removed, but the node is still used for routing
+		std::atomic<bool> present;
+		Node(const Key& key, Info&& info, NodeBase* parent) : NodeBase(parent, 1), m_key(key), m_info(std::move(info)), present(true) {}
+	};
+	typedef ConcurrentDictionaryDetail::SpinLock SpinLock;
+	typedef ConcurrentDictionaryDetail::Epochs<Node> Epochs;
+	static constexpr std::uint64_t Unlinked = 1;
+	static constexpr std::uint64_t Shrinking = 2;
+	static constexpr std::uint64_t ShrinkCount = 4;
+	/**
+	* Outputs of nodeCondition, other than the new height.
+	*/
+	enum : int {
+		UnlinkRequired = -1,
+		RebalanceRequired = -2,
+		NothingRequired = -3
+	};
+	/**
+	* Outputs of the attempts, Retry means that the thread has to go one level back.
+	*/
+	enum Result {
+		Retry,
+		Failed,
+		Succeeded
+	};
+	//the head is the right child of the holder, the holder is never locked by a rotation, so its version is always 0
+	mutable NodeBase holder;
+	std::atomic<std::size_t> elements;
+	Compare comp;
+	mutable Epochs epochs;
+	/**
+	* Outputs the height of a node, 0 for nullptr.
+	*/
+	static int getHeight(Node* curr);
+	/**
+	* Waits until a rotation which moves the node down ends.
+	*/
+	static void waitUntilNotChanging(Node* curr);
+	/**
+	* Optimistic descent from node in direction dir, nodeV is the version of node which was validated before.
+	* missing(parent, dir, parentV) is called when there is no node with the key, found(parent, node) when there is one,
+	* they can output Retry as well.
+	*/
+	template<typename Missing, typename Found>
+	Result attempt(const Key& key, NodeBase* node, int dir, std::uint64_t nodeV, Missing& missing, Found& found) const;
+	/**
+	* Repeats the descent from the head until it is done, inside of an epoch guard. Outputs true on Succeeded.
+	*/
+	template<typename Missing, typename Found>
+	bool run(const Key& key, Missing missing, Found found) const;
+	/**
+	* Common part of the insertions. make() creates the info of a new element, update(Info&) changes an existing one.
+	* Outputs true when a new element was created.
+	*/
+	template<typename Make, typename Update>
+	bool put(const Key& key, Make make, Update update);
+	/**
+	* Links a new node as the dir child of node, if node has not changed since nodeV.
+	*/
+	template<typename Make>
+	Result attemptInsert(const Key& key, NodeBase* node, int dir, std::uint64_t nodeV, Make& make);
+	/**
+	* Updates the info of an existing node, or makes a routing node present again.
+	*/
+	template<typename Make, typename Update>
+	Result attemptUpdate(Node* node, Make& make, Update& update);
+	/**
+	* Removes the element of node, unlinks the node when it has at most one child.
+	*/
+	Result attemptRemove(NodeBase* parent, Node* node);
+	/**
+	* Outputs UnlinkRequired, RebalanceRequired, NothingRequired or the new height of the node.
+	* It is done without locks, so it is only a hint.
+	*/
+	int nodeCondition(Node* curr) const;
+	/**
+	* Goes up from node and fixes the heights, the balance and the routing nodes which can be unlinked.
+	*/
+	void fixHeightAndRebalance(NodeBase* node);
+	/**
+	* The methods below require the locks of the nodes they are changing. Each of them outputs the next node to fix or nullptr.
+	*/
+	NodeBase* fixHeight(NodeBase* node);
+	NodeBase* rebalance(NodeBase* parent, Node* node);
+	NodeBase* rebalanceToRight(NodeBase* parent, Node* node, Node* left, int rightHeight);
+	NodeBase* rebalanceToLeft(NodeBase* parent, Node* node, Node* right, int leftHeight);
+	NodeBase* rightRotate(NodeBase* parent, Node* node, Node* left, int rightHeight, int leftLeftHeight, Node* leftRight, int leftRightHeight);
+	NodeBase* leftRotate(NodeBase* parent, Node* node, Node* right, int leftHeight, int rightRightHeight, Node* rightLeft, int rightLeftHeight);
+	NodeBase* rightRotateOverLeft(NodeBase* parent, Node* node, Node* left, int rightHeight, int leftLeftHeight, Node* leftRight, int leftRightLeftHeight);
+	NodeBase* leftRotateOverRight(NodeBase* parent, Node* node, Node* right, int leftHeight, int rightRightHeight, Node* rightLeft, int rightLeftRightHeight);
+	/**
+	* Replaces node (with at most one child) by its child. Outputs false when it is no longer possible.
+	*/
+	bool unlink(NodeBase* parent, Node* node);
+public:
+	ConcurrentDictionary();
+	explicit ConcurrentDictionary(const Compare& c);
+	ConcurrentDictionary(const ConcurrentDictionary& x) = delete;
+	ConcurrentDictionary& operator=(const ConcurrentDictionary& x) = delete;
+	~ConcurrentDictionary();
+	/**
+	* Inserts an element, outputs false (and does not change anything) when the key is already in the dictionary.
+	*/
+	bool insert(const Key& key, const Info& info);
+	/**
+	* Inserts an element or overwrites the info of an existing one. Outputs true when the element was inserted.
+	*/
+	bool insert_or_assign(const Key& key, const Info& info);
+	/**
+	* Applies update(Info&) to the info of key, a new element with Info() is created first if there is no such key.
+	* update is called under the lock of the node. Outputs true when the element was inserted.
+	*/
+	template<typename Update>
+	bool upsert(const Key& key, Update update);
+	/**
+	* Removes an element, outputs false when there is no such key.
+	*/
+	bool remove(const Key& key);
+	/**
+	* Copies the info of key to info, outputs false when there is no such key.
+	*/
+	bool find(const Key& key, Info& info) const;
+	/**
+	* Outputs true when the key is in the dictionary, no lock is taken.
+	*/
+	bool contains(const Key& key) const;
+	/**
+	* Outputs the number of elements.
+	*/
+	std::size_t size() const;
+	/**
+	* Outputs true when there are no elements.
+	*/
+	bool empty() const;
+	/**
+	* Copies the elements to a Dictionary (in O(n), it is built from the sorted elements).
+	* It must not run at the same time as the writers.
+	*/
+	Dictionary<Key, Info, Compare> toDictionary() const;
+};
+
+template<typename Key, typename Info, typename Compare>
+ConcurrentDictionary<Key, Info, Compare>::ConcurrentDictionary() : holder(nullptr, 0), elements(0), comp() {}
+
+template<typename Key, typename Info, typename Compare>
+ConcurrentDictionary<Key, Info, Compare>::ConcurrentDictionary(const Compare& c) : holder(nullptr, 0), elements(0), comp(c) {}
+
+template<typename Key, typename Info, typename Compare>
+ConcurrentDictionary<Key, Info, Compare>::~ConcurrentDictionary() {
+	//nothing runs concurrently now, the unlinked nodes are deleted by epochs
+	std::vector<Node*> stack;
+	if (Node* head = holder.right.load())
+		stack.push_back(head);
+	while (!stack.empty()) {
+		Node* curr = stack.back();
+		stack.pop_back();
+		if (Node* left = curr->left.load())
+			stack.push_back(left);
+		if (Node* right = curr->right.load())
+			stack.push_back(right);
+		delete curr;
+	}
+}
+
+template<typename Key, typename Info, typename Compare>
+int ConcurrentDictionary<Key, Info, Compare>::getHeight(Node* curr) {
+	return curr ? curr->height.load() : 0;
+}
+
+template<typename Key, typename Info, typename Compare>
+void ConcurrentDictionary<Key, Info, Compare>::waitUntilNotChanging(Node* curr) {
+	//a rotation changes only a few links, so it is worth spinning for a while before giving up the time slice
+	for (int spins = 0; curr->version.load() & Shrinking; ++spins) {
+		if (spins >= 100)
+			std::this_thread::yield();
+	}
+}
+
+template<typename Key, typename Info, typename Compare>
+template<typename Missing, typename Found>
+typename ConcurrentDictionary<Key, Info, Compare>::Result ConcurrentDictionary<Key, Info, Compare>::attempt(const Key& key, NodeBase* node, int dir, std::uint64_t nodeV, Missing& missing, Found& found) const {
+	while (true) {
+		Node* child = node->child(dir).load();
+		//the link is valid only if node was not moved down (or unlinked) since it was validated
+		if (node->version.load() != nodeV)
+			return Retry;
+		if (!child) {
+			Result result = missing(node, dir, nodeV);
+			if (result != Retry)
+				return result;
+			continue;
+		}
+		int next = DictionaryDetail::compareKeys(comp, key, child->m_key, 0);
+		if (next == 0) {
+			Result result = found(node, child);
+			if (result != Retry)
+				return result;
+			continue;
+		}
+		std::uint64_t childV = child->version.load();
+		if (childV & Shrinking) {
+			waitUntilNotChanging(child);
+		}
+		else if (childV != Unlinked and child == node->child(dir).load()) {
+			if (node->version.load() != nodeV)
+				return Retry;
+			//child is validated, node does not have to stay unchanged anymore (hand-over-hand)
+			Result result = attempt(key, child, next, childV, missing, found);
+			if (result != Retry)
+				return result;
+		}
+	}
+}
+
+template<typename Key, typename Info, typename Compare>
+template<typename Missing, typename Found>
+bool ConcurrentDictionary<Key, Info, Compare>::run(const Key& key, Missing missing, Found found) const {
+	typename Epochs::Guard guard(epochs);
+	Result result;
+	do {
+		result = attempt(key, &holder, 1, 0, missing, found);
+	} while (result == Retry);
+	return result == Succeeded;
+}
+
+template<typename Key, typename Info, typename Compare>
+template<typename Make, typename Update>
+bool ConcurrentDictionary<Key, Info, Compare>::put(const Key& key, Make make, Update update) {
+	return run(key,
+		[&](NodeBase* parent, int dir, std::uint64_t parentV) { return attemptInsert(key, parent, dir, parentV, make); },
+		[&](NodeBase*, Node* node) { return attemptUpdate(node, make, update); });
+}
+
+template<typename Key, typename Info, typename Compare>
+template<typename Make>
+typename ConcurrentDictionary<Key, Info, Compare>::Result ConcurrentDictionary<Key, Info, Compare>::attemptInsert(const Key& key, NodeBase* node, int dir, std::uint64_t nodeV, Make& make) {
+	{
+		std::lock_guard<SpinLock> lock(node->lock);
+		if (node->version.load() != nodeV or node->child(dir).load())
+			return Retry;
+		node->child(dir).store(new Node(key, make(), node));
+	}
+	++elements;
+	fixHeightAndRebalance(node);
+	return Succeeded;
+}
+
+template<typename Key, typename Info, typename Compare>
+template<typename Make, typename Update>
+typename ConcurrentDictionary<Key, Info, Compare>::Result ConcurrentDictionary<Key, Info, Compare>::attemptUpdate(Node* node, Make& make, Update& update) {
+	std::lock_guard<SpinLock> lock(node->lock);
+	if (node->version.load() == Unlinked)
+		return Retry;
+	if (node->present.load()) {
+		update(node->m_info);
+		return Failed;
+	}
+	//a routing node gets its element back, the structure of the tree does not change
+	node->m_info = make();
+	node->present.store(true);
+	++elements;
+	return Succeeded;
+}
+
+template<typename Key, typename Info, typename Compare>
+typename ConcurrentDictionary<Key, Info, Compare>::Result ConcurrentDictionary<Key, Info, Compare>::attemptRemove(NodeBase* parent, Node* node) {
+	if (!node->present.load())
+		return Failed;
+	if (node->left.load() and node->right.load()) {
+		//two children, the node stays as a routing node
+		std::lock_guard<SpinLock> lock(node->lock);
+		if (node->version.load() == Unlinked or !node->left.load() or !node->right.load())
+			return Retry;
+		if (!node->present.load())
+			return Failed;
+		node->present.store(false);
+	}
+	else {
+		{
+			std::lock_guard<SpinLock> parentLock(parent->lock);
+			if (parent->version.load() == Unlinked or node->up.load() != parent or node->version.load() == Unlinked)
+				return Retry;
+			std::lock_guard<SpinLock> lock(node->lock);
+			if (!node->present.load())
+				return Failed;
+			node->present.store(false);
+			//a child may have been added meanwhile, then it is a routing node until it can be unlinked
+			if (!node->left.load() or !node->right.load())
+				unlink(parent, node);
+		}
+		fixHeightAndRebalance(parent);
+	}
+	--elements;
+	return Succeeded;
+}
+
+template<typename Key, typename Info, typename Compare>
+int ConcurrentDictionary<Key, Info, Compare>::nodeCondition(Node* curr) const {
+	Node* left = curr->left.load();
+	Node* right = curr->right.load();
+	if ((!left or !right) and !curr->present.load())
+		return UnlinkRequired;
+	int height = curr->height.load();
+	int leftHeight = getHeight(left);
+	int rightHeight = getHeight(right);
+	int newHeight = 1 + std::max(leftHeight, rightHeight);
+	int balance = leftHeight - rightHeight;
+	if (balance < -1 or balance > 1)
+		return RebalanceRequired;
+	return height != newHeight ? newHeight : NothingRequired;
+}
+
+template<typename Key, typename Info, typename Compare>
+void ConcurrentDictionary<Key, Info, Compare>::fixHeightAndRebalance(NodeBase* node) {
+	//a rotation may output a damaged node below the rotated subtree, then the height of its parent is not fixed on the way up,
+	//so the parents of the rebalanced subtrees are checked again at the end (only a limited number of them, it is only a hint)
+	NodeBase* pending[64];
+	std::size_t count = 0;
+	while (true) {
+		//only the holder has no parent
+		Node* curr = node and node->up.load() ? static_cast<Node*>(node) : nullptr;
+		int condition = curr ? nodeCondition(curr) : NothingRequired;
+		if (condition == NothingRequired or curr->version.load() == Unlinked) {
+			if (count == 0)
+				return;
+			node = pending[--count];
+		}
+		else if (condition != UnlinkRequired and condition != RebalanceRequired) {
+			std::lock_guard<SpinLock> lock(curr->lock);
+			node = fixHeight(curr);
+		}
+		else {
+			NodeBase* parent = curr->up.load();
+			std::lock_guard<SpinLock> parentLock(parent->lock);
+			if (parent->version.load() != Unlinked and curr->up.load() == parent) {
+				std::lock_guard<SpinLock> lock(curr->lock);
+				node = rebalance(parent, curr);
+				if (count < 64)
+					pending[count++] = parent;
+			}
+			//otherwise the parent has changed, the same node is tried again
+		}
+	}
+}
+
+template<typename Key, typename Info, typename Compare>
+typename ConcurrentDictionary<Key, Info, Compare>::NodeBase* ConcurrentDictionary<Key, Info, Compare>::fixHeight(NodeBase* node) {
+	if (!node->up.load())
+		return nullptr;
+	int condition = nodeCondition(static_cast<Node*>(node));
+	switch (condition) {
+	case RebalanceRequired:
+	case UnlinkRequired:
+		//it needs the lock of the parent as well
+		return node;
+	case NothingRequired:
+		return nullptr;
+	default:
+		node->height.store(condition);
+		return node->up.load();
+	}
+}
+
+template<typename Key, typename Info, typename Compare>
+typename ConcurrentDictionary<Key, Info, Compare>::NodeBase* ConcurrentDictionary<Key, Info, Compare>::rebalance(NodeBase* parent, Node* node) {
+	Node* left = node->left.load();
+	Node* right = node->right.load();
+	if ((!left or !right) and !node->present.load()) {
+		if (unlink(parent, node))
+			return fixHeight(parent);
+		return node;
+	}
+	int height = node->height.load();
+	int leftHeight = getHeight(left);
+	int rightHeight = getHeight(right);
+	int newHeight = 1 + std::max(leftHeight, rightHeight);
+	int balance = leftHeight - rightHeight;
+	if (balance > 1)
+		return rebalanceToRight(parent, node, left, rightHeight);
+	if (balance < -1)
+		return rebalanceToLeft(parent, node, right, leftHeight);
+	if (newHeight != height) {
+		node->height.store(newHeight);
+		return fixHeight(parent);
+	}
+	return nullptr;
+}
+
+template<typename Key, typename Info, typename Compare>
+typename ConcurrentDictionary<Key, Info, Compare>::NodeBase* ConcurrentDictionary<Key, Info, Compare>::rebalanceToRight(NodeBase* parent, Node* node, Node* left, int rightHeight) {
+	std::lock_guard<SpinLock> leftLock(left->lock);
+	if (left->height.load() - rightHeight <= 1)
+		return node;
+	Node* leftRight = left->right.load();
+	int leftLeftHeight = getHeight(left->left.load());
+	int leftRightHeight = getHeight(leftRight);
+	if (leftLeftHeight >= leftRightHeight)
+		return rightRotate(parent, node, left, rightHeight, leftLeftHeight, leftRight, leftRightHeight);
+	{
+		std::lock_guard<SpinLock> leftRightLock(leftRight->lock);
+		leftRightHeight = leftRight->height.load();
+		if (leftLeftHeight >= leftRightHeight)
+			return rightRotate(parent, node, left, rightHeight, leftLeftHeight, leftRight, leftRightHeight);
+		int leftRightLeftHeight = getHeight(leftRight->left.load());
+		int balance = leftLeftHeight - leftRightLeftHeight;
+		//double rotation only when it does not leave left unbalanced
+		if (balance >= -1 and balance <= 1)
+			return rightRotateOverLeft(parent, node, left, rightHeight, leftLeftHeight, leftRight, leftRightLeftHeight);
+	}
+	//left is fixed first, node is rebalanced afterwards if it is still needed
+	return rebalanceToLeft(node, left, leftRight, leftLeftHeight);
+}
+
+template<typename Key, typename Info, typename Compare>
+typename ConcurrentDictionary<Key, Info, Compare>::NodeBase* ConcurrentDictionary<Key, Info, Compare>::rebalanceToLeft(NodeBase* parent, Node* node, Node* right, int leftHeight) {
+	std::lock_guard<SpinLock> rightLock(right->lock);
+	if (right->height.load() - leftHeight <= 1)
+		return node;
+	Node* rightLeft = right->left.load();
+	int rightRightHeight = getHeight(right->right.load());
+	int rightLeftHeight = getHeight(rightLeft);
+	if (rightRightHeight >= rightLeftHeight)
+		return leftRotate(parent, node, right, leftHeight, rightRightHeight, rightLeft, rightLeftHeight);
+	{
+		std::lock_guard<SpinLock> rightLeftLock(rightLeft->lock);
+		rightLeftHeight = rightLeft->height.load();
+		if (rightRightHeight >= rightLeftHeight)
+			return leftRotate(parent, node, right, leftHeight, rightRightHeight, rightLeft, rightLeftHeight);
+		int rightLeftRightHeight = getHeight(rightLeft->right.load());
+		int balance = rightRightHeight - rightLeftRightHeight;
+		if (balance >= -1 and balance <= 1)
+			return leftRotateOverRight(parent, node, right, leftHeight, rightRightHeight, rightLeft, rightLeftRightHeight);
+	}
+	return rebalanceToRight(node, right, rightLeft, rightRightHeight);
+}
+
+template<typename Key, typename Info, typename Compare>
+typename ConcurrentDictionary<Key, Info, Compare>::NodeBase* ConcurrentDictionary<Key, Info, Compare>::rightRotate(NodeBase* parent, Node* node, Node* left, int rightHeight, int leftLeftHeight, Node* leftRight, int leftRightHeight) {
+	std::uint64_t version = node->version.load();
+	Node* parentLeft = parent->left.load();
+	//node is moved down, readers which are in it have to wait and the ones which have passed it have to go back
+	node->version.store(version | Shrinking);
+	node->left.store(leftRight);
+	if (leftRight)
+		leftRight->up.store(node);
+	left->right.store(node);
+	node->up.store(left);
+	if (parentLeft == node)
+		parent->left.store(left);
+	else
+		parent->right.store(left);
+	left->up.store(parent);
+	int newHeight = 1 + std::max(leftRightHeight, rightHeight);
+	node->height.store(newHeight);
+	left->height.store(1 + std::max(leftLeftHeight, newHeight));
+	node->version.store(version + ShrinkCount);
+	//the nodes which are still damaged are fixed by the caller, the deepest first
+	int balance = leftRightHeight - rightHeight;
+	if (balance < -1 or balance > 1)
+		return node;
+	if ((!leftRight or rightHeight == 0) and !node->present.load())
+		return node;
+	balance = leftLeftHeight - newHeight;
+	if (balance < -1 or balance > 1)
+		return left;
+	if (leftLeftHeight == 0 and !left->present.load())
+		return left;
+	return fixHeight(parent);
+}
+
+template<typename Key, typename Info, typename Compare>
+typename ConcurrentDictionary<Key, Info, Compare>::NodeBase* ConcurrentDictionary<Key, Info, Compare>::leftRotate(NodeBase* parent, Node* node, Node* right, int leftHeight, int rightRightHeight, Node* rightLeft, int rightLeftHeight) {
+	std::uint64_t version = node->version.load();
+	Node* parentLeft = parent->left.load();
+	node->version.store(version | Shrinking);
+	node->right.store(rightLeft);
+	if (rightLeft)
+		rightLeft->up.store(node);
+	right->left.store(node);
+	node->up.store(right);
+	if (parentLeft == node)
+		parent->left.store(right);
+	else
+		parent->right.store(right);
+	right->up.store(parent);
+	int newHeight = 1 + std::max(leftHeight, rightLeftHeight);
+	node->height.store(newHeight);
+	right->height.store(1 + std::max(newHeight, rightRightHeight));
+	node->version.store(version + ShrinkCount);
+	int balance = rightLeftHeight - leftHeight;
+	if (balance < -1 or balance > 1)
+		return node;
+	if ((!rightLeft or leftHeight == 0) and !node->present.load())
+		return node;
+	balance = rightRightHeight - newHeight;
+	if (balance < -1 or balance > 1)
+		return right;
+	if (rightRightHeight == 0 and !right->present.load())
+		return right;
+	return fixHeight(parent);
+}
+
+template<typename Key, typename Info, typename Compare>
+typename ConcurrentDictionary<Key, Info, Compare>::NodeBase* ConcurrentDictionary<Key, Info, Compare>::rightRotateOverLeft(NodeBase* parent, Node* node, Node* left, int rightHeight, int leftLeftHeight, Node* leftRight, int leftRightLeftHeight) {
+	std::uint64_t nodeVersion = node->version.load();
+	std::uint64_t leftVersion = left->version.load();
+	Node* parentLeft = parent->left.load();
+	Node* leftRightLeft = leftRight->left.load();
+	Node* leftRightRight = leftRight->right.load();
+	int leftRightRightHeight = getHeight(leftRightRight);
+	//node and left are moved down, leftRight goes up to the place of node
+	node->version.store(nodeVersion | Shrinking);
+	left->version.store(leftVersion | Shrinking);
+	node->left.store(leftRightRight);
+	if (leftRightRight)
+		leftRightRight->up.store(node);
+	left->right.store(leftRightLeft);
+	if (leftRightLeft)
+		leftRightLeft->up.store(left);
+	leftRight->left.store(left);
+	left->up.store(leftRight);
+	leftRight->right.store(node);
+	node->up.store(leftRight);
+	if (parentLeft == node)
+		parent->left.store(leftRight);
+	else
+		parent->right.store(leftRight);
+	leftRight->up.store(parent);
+	int newHeight = 1 + std::max(leftRightRightHeight, rightHeight);
+	node->height.store(newHeight);
+	int newLeftHeight = 1 + std::max(leftLeftHeight, leftRightLeftHeight);
+	left->height.store(newLeftHeight);
+	node->version.store(nodeVersion + ShrinkCount);
+	left->version.store(leftVersion + ShrinkCount);
+	//a routing node with one child is unlinked right away, otherwise it would be a second damaged node next to node
+	if ((leftLeftHeight == 0 or leftRightLeftHeight == 0) and !left->present.load() and unlink(leftRight, left))
+		newLeftHeight = std::max(leftLeftHeight, leftRightLeftHeight);
+	leftRight->height.store(1 + std::max(newLeftHeight, newHeight));
+	int balance = leftRightRightHeight - rightHeight;
+	if (balance < -1 or balance > 1)
+		return node;
+	if ((!leftRightRight or rightHeight == 0) and !node->present.load())
+		return node;
+	balance = newLeftHeight - newHeight;
+	if (balance < -1 or balance > 1)
+		return leftRight;
+	return fixHeight(parent);
+}
+
+template<typename Key, typename Info, typename Compare>
+typename ConcurrentDictionary<Key, Info, Compare>::NodeBase* ConcurrentDictionary<Key, Info, Compare>::leftRotateOverRight(NodeBase* parent, Node* node, Node* right, int leftHeight, int rightRightHeight, Node* rightLeft, int rightLeftRightHeight) {
+	std::uint64_t nodeVersion = node->version.load();
+	std::uint64_t rightVersion = right->version.load();
+	Node* parentLeft = parent->left.load();
+	Node* rightLeftLeft = rightLeft->left.load();
+	Node* rightLeftRight = rightLeft->right.load();
+	int rightLeftLeftHeight = getHeight(rightLeftLeft);
+	node->version.store(nodeVersion | Shrinking);
+	right->version.store(rightVersion | Shrinking);
+	node->right.store(rightLeftLeft);
+	if (rightLeftLeft)
+		rightLeftLeft->up.store(node);
+	right->left.store(rightLeftRight);
+	if (rightLeftRight)
+		rightLeftRight->up.store(right);
+	rightLeft->right.store(right);
+	right->up.store(rightLeft);
+	rightLeft->left.store(node);
+	node->up.store(rightLeft);
+	if (parentLeft == node)
+		parent->left.store(rightLeft);
+	else
+		parent->right.store(rightLeft);
+	rightLeft->up.store(parent);
+	int newHeight = 1 + std::max(leftHeight, rightLeftLeftHeight);
+	node->height.store(newHeight);
+	int newRightHeight = 1 + std::max(rightLeftRightHeight, rightRightHeight);
+	right->height.store(newRightHeight);
+	node->version.store(nodeVersion + ShrinkCount);
+	right->version.store(rightVersion + ShrinkCount);
+	if ((rightRightHeight == 0 or rightLeftRightHeight == 0) and !right->present.load() and unlink(rightLeft, right))
+		newRightHeight = std::max(rightLeftRightHeight, rightRightHeight);
+	rightLeft->height.store(1 + std::max(newHeight, newRightHeight));
+	int balance = rightLeftLeftHeight - leftHeight;
+	if (balance < -1 or balance > 1)
+		return node;
+	if ((!rightLeftLeft or leftHeight == 0) and !node->present.load())
+		return node;
+	balance = newRightHeight - newHeight;
+	if (balance < -1 or balance > 1)
+		return rightLeft;
+	return fixHeight(parent);
+}
+
+template<typename Key, typename Info, typename Compare>
+bool ConcurrentDictionary<Key, Info, Compare>::unlink(NodeBase* parent, Node* node) {
+	Node* parentLeft = parent->left.load();
+	if (parentLeft != node and parent->right.load() != node)
+		return false;
+	Node* left = node->left.load();
+	Node* right = node->right.load();
+	if (left and right)
+		return false;
+	Node* splice = left ? left : right;
+	if (parentLeft == node)
+		parent->left.store(splice);
+	else
+		parent->right.store(splice);
+	if (splice)
+		splice->up.store(parent);
+	node->version.store(Unlinked);
+	node->present.store(false);
+	//readers may still be inside of the node
+	epochs.retire(node);
+	return true;
+}
+
+template<typename Key, typename Info, typename Compare>
+bool ConcurrentDictionary<Key, Info, Compare>::insert(const Key& key, const Info& info) {
+	return put(key, [&info]() { return info; }, [](Info&) {});
+}
+
+template<typename Key, typename Info, typename Compare>
+bool ConcurrentDictionary<Key, Info, Compare>::insert_or_assign(const Key& key, const Info& info) {
+	return put(key, [&info]() { return info; }, [&info](Info& existing) { existing = info; });
+}
+
+template<typename Key, typename Info, typename Compare>
+template<typename Update>
+bool ConcurrentDictionary<Key, Info, Compare>::upsert(const Key& key, Update update) {
+	return put(key,
+		[&update]() {
+			Info info = Info();
+			update(info);
+			return info;
+		},
+		update);
+}
+
+template<typename Key, typename Info, typename Compare>
+bool ConcurrentDictionary<Key, Info, Compare>::remove(const Key& key) {
+	return run(key,
+		[](NodeBase*, int, std::uint64_t) { return Failed; },
+		[this](NodeBase* parent, Node* node) { return attemptRemove(parent, node); });
+}
+
+template<typename Key, typename Info, typename Compare>
+bool ConcurrentDictionary<Key, Info, Compare>::find(const Key& key, Info& info) const {
+	return run(key,
+		[](NodeBase*, int, std::uint64_t) { return Failed; },
+		[&info](NodeBase*, Node* node) {
+			std::lock_guard<SpinLock> lock(node->lock);
+			if (!node->present.load())
+				return Failed;
+			info = node->m_info;
+			return Succeeded;
+		});
+}
+
+template<typename Key, typename Info, typename Compare>
+bool ConcurrentDictionary<Key, Info, Compare>::contains(const Key& key) const {
+	return run(key,
+		[](NodeBase*, int, std::uint64_t) { return Failed; },
+		[](NodeBase*, Node* node) { return node->present.load() ? Succeeded : Failed; });
+}
+
+template<typename Key, typename Info, typename Compare>
+std::size_t ConcurrentDictionary<Key, Info, Compare>::size() const {
+	return elements.load();
+}
+
+template<typename Key, typename Info, typename Compare>
+bool ConcurrentDictionary<Key, Info, Compare>::empty() const {
+	return size() == 0;
+}
+
+template<typename Key, typename Info, typename Compare>
+Dictionary<Key, Info, Compare> ConcurrentDictionary<Key, Info, Compare>::toDictionary() const {
+	std::vector<std::pair<Key, Info>> sorted;
+	sorted.reserve(size());
+	//in order, without recursion
+	std::vector<Node*> stack;
+	Node* curr = holder.right.load();
+	while (curr or !stack.empty()) {
+		while (curr) {
+			stack.push_back(curr);
+			curr = curr->left.load();
+		}
+		curr = stack.back();
+		stack.pop_back();
+		if (curr->present.load())
+			sorted.emplace_back(curr->m_key, curr->m_info);
+		curr = curr->right.load();
+	}
+	return Dictionary<Key, Info, Compare>(sorted.begin(), sorted.end());
+}
@@ -1,7 +1,149 @@
 #pragma once
 #include<iostream>
-template<typename Key, typename Info>
+#include<fstream>
+#include<cstring>
+#include<memory>
+#include<functional>
+#include<limits>
+#include<string>
+#include<string_view>
+#include<type_traits>
+#include<utility>
+#include<algorithm>
+#include<tuple>
+#include<vector>
+#include<future>
+#include<thread>
+#include"FrozenDictionary.h"
+#include"Serializer.h"
+#if __cplusplus > 201703L && __has_include(<compare>)
+#include<compare>
+#endif
+/**
+* \brief Storage policies of the Dictionary (the last template parameter).
+* AVLTree is the default one, BPlusTree<Fanout> is defined in BPlusTree.h.
+*/
+struct AVLTree {};
+template<std::size_t Fanout = 64>
+struct BPlusTree {};
+/**
+* \brief Aggregate policies of the Dictionary (the template parameter after the storage).
+* A policy has value_type, identity(), value(key, info) (the value of one element) and an associative combine(a, b),
+* every node keeps the combined value of its subtree, so aggregate(lo, hi) is O(logN). NoAggregate is the default one.
+*/
+struct NoAggregate {};
+template<typename T>
+struct SumAggregate {
+	typedef T value_type;
+	T identity() const { return T(); }
+	template<typename Key, typename Info>
+	T value(const Key&, const Info& info) const { return T(info); }
+	T combine(const T& a, const T& b) const { return a + b; }
+};
+template<typename T>
+struct MaxAggregate {
+	typedef T value_type;
+	T identity() const { return std::numeric_limits<T>::lowest(); }
+	template<typename Key, typename Info>
+	T value(const Key&, const Info& info) const { return T(info); }
+	T combine(const T& a, const T& b) const { return a < b ? b : a; }
+};
+template<typename T>
+struct MinAggregate {
+	typedef T value_type;
+	T identity() const { return std::numeric_limits<T>::max(); }
+	template<typename Key, typename Info>
+	T value(const Key&, const Info& info) const { return T(info); }
+	T combine(const T& a, const T& b) const { return b < a ? b : a; }
+};
+namespace DictionaryDetail {
+	/**
+	* Aggregate of the subtree kept in the node, nothing for NoAggregate.
+	*/
+	template<typename Aggregate>
+	struct AggregateField {
+		typename Aggregate::value_type aggregate;
+		AggregateField() : aggregate() {}
+	};
+	template<>
+	struct AggregateField<NoAggregate> {};
+	/**
+	* True when Compare is transparent (has is_transparent).
+	*/
+	template<typename Compare, typename = void>
+	struct isTransparent : std::false_type {};
+	template<typename Compare>
+	struct isTransparent<Compare, std::void_t<typename Compare::is_transparent>> : std::true_type {};
+	/**
+	* Three-way comparison of two keys, outputs <0, 0 or >0. Uses a.compare(b) if there is one (std::string, std::string_view),
+	* then operator<=> (C++20), otherwise operator< twice.
+	*/
+	template<typename A, typename B>
+	auto threeWay(const A& a, const B& b, int) -> decltype(int(a.compare(b))) {
+		return a.compare(b);
+	}
+#if __cplusplus > 201703L && __has_include(<compare>)
+	template<typename A, typename B>
+	auto threeWay(const A& a, const B& b, long) -> decltype(int((a <=> b) < 0)) {
+		auto order = a <=> b;
+		return (order > 0) - (order < 0);
+	}
+#endif
+	template<typename A, typename B>
+	int threeWay(const A& a, const B& b, ...) {
+		return (b < a) - (a < b);
+	}
+	/**
+	* Compares keys with comp.compare(a, b) if Compare has it (one comparison), otherwise with comp(a, b) and comp(b, a).
+	*/
+	template<typename Compare, typename A, typename B>
+	auto compareKeys(const Compare& comp, const A& a, const B& b, int) -> decltype(int(comp.compare(a, b))) {
+		return comp.compare(a, b);
+	}
+	template<typename Compare, typename A, typename B>
+	int compareKeys(const Compare& comp, const A& a, const B& b, long) {
+		if (comp(a, b))
+			return -1;
+		return comp(b, a) ? 1 : 0;
+	}
+}
+/**
+* \brief Three-way comparison policy, can be used as Compare of the Dictionary.
+* Besides operator() (less than) it has compare(a, b) which outputs <0, 0 or >0, so insert, find and remove
+* compare the key with each node on the path only once. ThreeWayCompare<> is transparent.
+* Any comparator with int compare(a, b) const consistent with its operator() is used the same way.
+*/
+template<typename T = void>
+struct ThreeWayCompare {
+	bool operator()(const T& a, const T& b) const {
+		return a < b;
+	}
+	int compare(const T& a, const T& b) const {
+		return DictionaryDetail::threeWay(a, b, 0);
+	}
+};
+template<>
+struct ThreeWayCompare<void> {
+	typedef void is_transparent;
+	template<typename A, typename B>
+	bool operator()(const A& a, const B& b) const {
+		return a < b;
+	}
+	template<typename A, typename B>
+	int compare(const A& a, const B& b) const {
+		return DictionaryDetail::threeWay(a, b, 0);
+	}
+};
+/**
+* \brief AVL tree based dictionary.
+* Keys are ordered with Compare (std::less<Key> by default), a Compare with compare(a, b) (e.g. ThreeWayCompare) costs one
+* comparison per node in insert, find and remove. If it is transparent (e.g. std::less<>) find, contains,
+* lower_bound, upper_bound and upsert accept anything comparable with Key, e.g. std::string_view for std::string keys.
+* Allocator is rebound to the node type, it can be any standard allocator, e.g. PoolAllocator from PoolAllocator.h.
+*/
+template<typename Key, typename Info, typename Compare = std::less<Key>, typename Allocator = std::allocator<std::pair<const Key, Info>>, typename Storage = AVLTree, typename Aggregate = NoAggregate>
 class Dictionary {
+	static_assert(std::is_same<Storage, AVLTree>::value, "Unknown storage, BPlusTree requires BPlusTree.h (it does not support aggregates)");
 public:
 	/**
 	* \brief Types of traversing the tree.
@@ -12,17 +154,40 @@ public:
 		Postorder
 	};
 private:
-	struct Node {
+	struct Node : DictionaryDetail::AggregateField<Aggregate> {
 		Key m_key;
 		Info m_info;
 		Node* left;
 		Node* right;
 		Node* up;
 		int height;
-		Node(const Key& key, const Info& info, int h = 1): m_key(key), m_info(info), left(nullptr), right(nullptr), up(nullptr), height(h)  {}
-		Node(const Key& key, const Info& info, Node* l, Node* r, Node* u, int h) : m_key(key), m_info(info), left(l), right(r), up(u), height(h) {}
+		//number of nodes in the subtree of this node (including the node)
+		std::size_t size;
+		/**
+		* Key is built from key, info is built from args, so both can be moved or constructed in place.
+		*/
+		template<typename K, typename... Args>
+		Node(K&& key, Args&&... args) : m_key(std::forward<K>(key)), m_info(std::forward<Args>(args)...), left(nullptr), right(nullptr), up(nullptr), height(1), size(1) {}
 	};
+	typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Node> NodeAllocator;
+	typedef std::allocator_traits<NodeAllocator> NodeTraits;
 	Node* head;
+	NodeAllocator alloc;
+	Compare comp;
+	/**
+	* Gives back the memory of all nodes at once if the allocator supports that (has bool release()) and
+	* nothing has to be destroyed. Outputs false if the nodes have to be deleted one by one.
+	*/
+	bool releaseAll();
+	/**
+	* Allocates and constructs a node, args are forwarded to the Node constructor.
+	*/
+	template<typename... Args>
+	Node* createNode(Args&&... args);
+	/**
+	* Destroys and deallocates a node.
+	*/
+	void destroyNode(Node* curr);
 	/**
 	* Clears the AVL & updates the curr element.
 	*/
@@ -36,6 +201,30 @@ private:
 	*/
 	int getHeight(Node* curr) const;
 	/**
+	* Outputs the number of nodes in the subtree of a node.
+	*/
+	std::size_t getSize(Node* curr) const;
+	/**
+	* Recalculates height and size (and the aggregate) of a node from its children.
+	*/
+	void update(Node* curr);
+	/**
+	* Recalculates the aggregate of a node from its children, nothing without an aggregate policy.
+	*/
+	void updateAggregate(Node* curr) const;
+	/**
+	* Recalculates the aggregates from a node which info has changed up to the head.
+	*/
+	void refresh(Node* curr) const;
+	/**
+	* Copies the aggregate of src to dst.
+	*/
+	void copyAggregate(Node* dst, const Node* src) const;
+	/**
+	* Outputs the number of elements which key is less than (or equal to if inclusive) a given key.
+	*/
+	std::size_t countLess(const Key& key, bool inclusive) const;
+	/**
 	* Outputs the calculated balance of a node. According to the left and right subtree.
 	*/
 	int getBalance(Node* curr) const;
@@ -70,15 +259,114 @@ private:
 	*/
 	void rightRotate(Node*& A);
 	/**
-	* Inserts the node and balances the tree.
+	* Outputs a reference to the pointer which holds the node: head or the left/right pointer of its parent.
+	*/
+	Node*& link(Node* curr);
+	/**
+	* Updates the height of a node and performs the rotations if it is unbalanced. Outputs the new root of the subtree.
+	*/
+	Node* rebalance(Node* curr);
+	/**
+	* Goes up from curr (using up pointers) and rebalances every node on the way.
+	* Rotations stop as soon as the height of a subtree stops changing, because no balance above can change then,
+	* only the sizes are updated up to the head.
+	*/
+	void retrace(Node* curr);
+	/**
+	* Inserts the node and balances the tree. The node is obtained from make() only when the key is not in the tree yet,
+	* make may move from key, that is fine because the key is not compared after that.
+	* Outputs false (and the existing node through newNode) when the key is already in the tree.
+	*/
+	template<typename K, typename Make>
+	bool insert(const K& key, Node*& newNode, Make make);
+	/**
+	* Descents used by the lookups, K is Key or (with a transparent Compare) anything comparable with Key.
+	* search outputs the node with the key or nullptr, lowerBound/upperBound the first node which key is not less/greater than key.
+	*/
+	template<typename K>
+	Node* search(const K& key) const;
+	template<typename K>
+	Node* lowerBound(const K& key) const;
+	template<typename K>
+	Node* upperBound(const K& key) const;
+	/**
+	* Unlinks an element from the tree, nodes are relinked so no key/info is copied.
+	* Outputs the unlinked node, or nullptr when the key was not found.
+	*/
+	Node* unlink(const Key& key);
+	/**
+	* Links count nodes (sorted by key) into a perfectly balanced subtree. Outputs the root of the subtree.
+	* Recursion depth is only log2(count).
+	*/
+	Node* build(Node** nodes, std::size_t count, Node* prev);
+	/**
+	* Replaces the content of the tree with the elements of a sorted, de-duplicated range of (key, info) pairs.
+	* Elements are forwarded, so a range of move_iterators moves keys and infos into the nodes.
+	*/
+	template<typename It>
+	void assignSorted(It first, It last);
+	/**
+	* Makes curr the parent of left and right and updates its height and size. Outputs curr.
+	*/
+	Node* attach(Node* curr, Node* left, Node* right);
+	/**
+	* Joins two AVL trees and a middle node, all keys of left < key of middle < all keys of right.
+	* Approche: The lower tree is attached along the spine of the higher one and rotations are done on the way back.
+	* O(|h(left) - h(right)| + 1). Outputs the root of the new tree (its up pointer is not updated).
+	*/
+	Node* join(Node* left, Node* middle, Node* right);
+	/**
+	* join when left is higher than right by more than 1.
+	*/
+	Node* joinRight(Node* left, Node* middle, Node* right);
+	/**
+	* join when right is higher than left by more than 1.
 	*/
-	void insert(Node*& curr, const Key& key, const Info& info, Node*& newNode);
+	Node* joinLeft(Node* left, Node* middle, Node* right);
 	/**
-	* Removes an element from the tree.
+	* Joins two AVL trees without a middle node, all keys of left < all keys of right.
 	*/
-	Node* remove(Node* curr, const Key& key);
+	Node* join2(Node* left, Node* right);
 	/**
-	* Compares the nodes. In a recursive way.
+	* Unlinks the maximal node of a tree. Outputs the root of the remaining tree.
+	*/
+	Node* splitLast(Node* curr, Node*& last);
+	/**
+	* Splits the tree into keys < key (left), the node with key (found, nullptr if there is none) and keys > key (right).
+	* O(logN).
+	*/
+	void split(Node* curr, const Key& key, Node*& left, Node*& found, Node*& right);
+	/**
+	* Runs first and second, in parallel if forks > 0. Both of them have to work on independent subtrees.
+	*/
+	template<typename First, typename Second>
+	static void forkJoin(int forks, First first, Second second);
+	/**
+	* Outputs how many levels of recursion of the set operations may be executed in parallel for trees of a given size.
+	* Nodes are created and deleted in parallel, so it is 0 for stateful allocators (e.g. PoolAllocator) which are not thread safe.
+	*/
+	int parallelLevels(std::size_t elements) const;
+	/**
+	* Join based union, elements of other are copied, infos of the same keys are merged with combine.
+	*/
+	template<typename Combine>
+	Node* unionNodes(Node* a, Node* b, Combine& combine, int forks);
+	/**
+	* Join based intersection, nodes of a which keys are not in b are deleted.
+	*/
+	template<typename Combine>
+	Node* intersectNodes(Node* a, Node* b, Combine& combine, int forks);
+	/**
+	* Join based difference, nodes of a which keys are in b are deleted.
+	*/
+	Node* differenceNodes(Node* a, Node* b, int forks);
+	/**
+	* Join based union which takes over the nodes of b.
+	*/
+	template<typename Combine>
+	Node* mergeNodes(Node* a, Node* b, Combine& combine, int forks);
+	/**
+	* Compares the nodes. Both trees are traversed at the same time with the use of up pointers.
 	*/
 	bool compareNodes(Node* a, Node* b) const;
 	/**
@@ -86,18 +374,29 @@ private:
 	*/
 	template<typename ToDo>
 	void uniTraversal(Node* curr, ToDo method, const TravelType type) const;
+	/**
+	* In order traversal of the nodes which key is in [lo, hi], a subtree is entered only if it can contain such keys.
+	*/
+	template<typename K, typename ToDo>
+	void visitRange(Node* curr, const K& lo, const K& hi, ToDo& method) const;
 public:
 	/**
 	* Iterator of the AVL tree.
 	*/
 	class iterator {
-		friend Dictionary<Key, Info>;
-		const Dictionary<Key, Info>* master;
+		friend Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>;
+		const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>* master;
 		mutable Node* curr;
-		iterator(Node* x, const Dictionary<Key, Info>* m);
+		iterator(Node* x, const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>* m);
 	public:
+		/**
+		* With an aggregate policy the info can be only read through the iterator, it has to be changed with modify so the aggregates stay valid.
+		*/
+		typedef typename std::conditional<std::is_same<Aggregate, NoAggregate>::value, Info&, const Info&>::type reference;
+
 		iterator();
 		iterator(const iterator& x);
+		iterator& operator=(const iterator& x) = default;
 		~iterator() = default;
 
 		bool operator==(const iterator& x) const;
@@ -114,7 +413,12 @@ public:
 
 		const Info& operator*() const;
 
-		Info& operator*();
+		reference operator*();
+		/**
+		* Functionality: Calls method(Info&) on the info of the element and updates the aggregates of its ancestors. O(logN).
+		*/
+		template<typename Update>
+		void modify(Update method);
 
 		const Key& getKey() const;
 
@@ -136,8 +440,8 @@ public:
 	* Reverse iterator of the AVL tree.
 	*/
 	class reverse_iterator : public iterator {
-		friend Dictionary<Key, Info>;
-		reverse_iterator(Node* x, const Dictionary<Key, Info>* m);
+		friend Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>;
+		reverse_iterator(Node* x, const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>* m);
 	public:
 		reverse_iterator();
 
@@ -164,6 +468,55 @@ public:
 	*/
 	typedef const reverse_iterator const_reverse_iterator;
 	/**
+	* Node handle owns a node extracted from the tree.
+	* The node can be inserted to the same or another Dictionary without any reallocation.
+	* If the handle still owns a node while being destroyed the node is deleted.
+	*/
+	class node_handle {
+		friend Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>;
+		Node* node;
+		NodeAllocator alloc;
+		node_handle(Node* x, const NodeAllocator& a);
+		/**
+		* Destroys the owned node.
+		*/
+		void reset();
+	public:
+		node_handle();
+		node_handle(node_handle&& x) noexcept;
+		node_handle(const node_handle& x) = delete;
+		~node_handle();
+
+		node_handle& operator=(node_handle&& x) noexcept;
+
+		node_handle& operator=(const node_handle& x) = delete;
+
+		bool empty() const;
+		/**
+		* The key can be modified while the node is not a part of any tree.
+		*/
+		Key& key() const;
+
+		Info& info() const;
+	};
+	/**
+	* View of the elements with keys in a range, made by range and prefix. The bounds are found once,
+	* the elements are visited lazily by the iterators, so taking the first k of them costs O(logN + k).
+	* The view is valid as long as the bounding elements are in the tree.
+	*/
+	class range_view {
+		friend Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>;
+		iterator first;
+		iterator last;
+		range_view(const iterator& first, const iterator& last);
+	public:
+		iterator begin() const;
+
+		iterator end() const;
+
+		bool empty() const;
+	};
+	/**
 	* An iterator to the smalles element of the tree.
 	* Complexity O(logN) where N is a number of element or O(h) here h is a height of the tree.
 	*/
@@ -186,9 +539,26 @@ public:
 	*/
 	Dictionary();
 	/**
+	* Constructor creates an empty tree which is going to use a given allocator.
+	*/
+	explicit Dictionary(const Allocator& a);
+	/**
+	* Constructor creates an empty tree which is going to order the keys with a given comparator.
+	*/
+	explicit Dictionary(const Compare& c, const Allocator& a = Allocator());
+	/**
+	* Constructor builds a tree from a sorted range of (key, info) pairs in O(n), see assign.
+	*/
+	template<typename It>
+	Dictionary(It first, It last, const Allocator& a = Allocator());
+	/**
 	* Copy constructor.
 	*/
-	Dictionary(const Dictionary<Key, Info>& x);
+	Dictionary(const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& x);
+	/**
+	* Move constructor. Takes over the nodes of x in O(1), x is left empty.
+	*/
+	Dictionary(Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>&& x) noexcept;
 	/**
 	* Destructor.
 	*/
@@ -198,6 +568,10 @@ public:
 	*/
 	int getHeight() const;
 	/**
+	* Outputs the number of elements. O(1), every node knows the size of its subtree.
+	*/
+	std::size_t size() const;
+	/**
 	* Checks whether the tree is empty.
 	*/
 	bool empty() const;
@@ -206,39 +580,134 @@ public:
 	*/
 	void clear();
 	/**
+	* Prepares the allocator for count new elements, if it supports that (e.g. PoolAllocator).
+	* Otherwise it does nothing.
+	*/
+	void reserve(std::size_t count);
+	/**
+	* Functionallity: Replaces the content of the tree with a range of (key, info) pairs, e.g. std::pair or std::map elements.
+	* The range has to be sorted by key and without duplicates, otherwise the tree is left untouched and "Range is not sorted!" is thrown.
+	* Approche: Nodes are created in order and linked into a perfectly balanced tree, there are no rotations. O(n).
+	* param[in] first : Beginning of the range.
+	* param[in] last : End of the range.
+	*/
+	template<typename It>
+	void assign(It first, It last);
+	/**
+	* Functionallity: Same as assign, but the range does not need to be sorted.
+	* Approche: Elements are copied to a buffer and sorted (O(nlogn)), infos of the same keys are merged
+	* in order of appearance with combine(Info& existing, Info incoming). Then the tree is built in O(n).
+	* Counting words is: d.assign(words.begin(), words.end(), [](int& a, int b) { a += b; });
+	* param[in] first : Beginning of the range.
+	* param[in] last : End of the range.
+	* param[in] combine : Method merging two infos of the same key.
+	*/
+	template<typename It, typename Combine>
+	void assign(It first, It last, Combine combine);
+	/**
 	* Assign operator.
 	*/
-	Dictionary& operator=(const Dictionary<Key, Info>& x);
+	Dictionary& operator=(const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& x);
+	/**
+	* Move assign operator. Clears the tree and takes over the nodes of x, x is left empty.
+	*/
+	Dictionary& operator=(Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>&& x) noexcept(NodeTraits::propagate_on_container_move_assignment::value or NodeTraits::is_always_equal::value);
 	/**
 	* Comparision operator.
 	*/
-	bool operator==(const Dictionary<Key, Info>& x) const;
+	bool operator==(const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& x) const;
 	/**
 	* Comparision operator.
 	*/
-	bool operator!=(const Dictionary<Key, Info>& x) const;
+	bool operator!=(const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& x) const;
 	/**
 	* Functionallity: Inserts the node to the AVL tree.
-	* Approche: I am using recursive insert. There is possible throw when key is already in the tree, however, public method outputs true/false in that case.
+	* Approche: I am using iterative insert, the tree is rebalanced on the way up only as long as heights are changing. When key is already in the tree nothing is changed and public method outputs false.
 	* param[in] key : Key of the element that is going to be inserted.
 	* param[in] info : Info of the element that is going to be inserted.
 	*/
 	bool insert(const Key& key, const Info& info);
 	/**
 	* Functionallity: Slightly modified insert method. It outputs the iterator to the a new element or an iterator to existing element.
-	* Approche: I am using recursive insert. There is possible throw when key is already in the tree, however, public method outputs true/false in that case.
+	* Approche: I am using iterative insert. When key is already in the tree nothing is changed and public method outputs false.
 	* param[in] key : Key of the element that is going to be inserted.
 	* param[in] info : Info of the element that is going to be inserted.
 	* param[in] it : A reference to iterator to which we want to provide information about the added/existing element.
 	*/
 	bool insert(const Key& key, const Info& info, iterator& it);
 	/**
+	* Functionallity: Same as insert, but key and info are moved into the new node instead of being copied.
+	* When the key is already in the tree key and info are left untouched.
+	* param[in] key : Key of the element that is going to be inserted.
+	* param[in] info : Info of the element that is going to be inserted.
+	*/
+	bool insert(Key&& key, Info&& info);
+	/**
+	* Functionallity: Inserts the node owned by the node handle. No allocation is made.
+	* When the key is already in the tree the handle keeps the node.
+	* Outputs an iterator to the new/existing element and true if the node was inserted.
+	* param[in] x : Node handle obtained from extract.
+	*/
+	std::pair<iterator, bool> insert(node_handle&& x);
+	/**
+	* Functionallity: Constructs the element in place. The first argument builds the key, the rest builds the info.
+	* Approche: The node is constructed before the descent (same as std::map::emplace), so if the key
+	* is already in the tree the new node is destroyed. Use try_emplace to avoid that.
+	* Outputs an iterator to the new/existing element and true if the element was inserted.
+	* param[in] args : Arguments of the key and info constructors.
+	*/
+	template<typename... Args>
+	std::pair<iterator, bool> emplace(Args&&... args);
+	/**
+	* Functionallity: Inserts an element with Info constructed from args, only if the key is not in the tree yet.
+	* Approche: Single descent, nothing is thrown. When the key exists args are left untouched.
+	* Outputs an iterator to the new/existing element and true if the element was inserted.
+	* param[in] key : Key of the element that is going to be inserted.
+	* param[in] args : Arguments passed to the Info constructor.
+	*/
+	template<typename... Args>
+	std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args);
+	/**
+	* Functionallity: Same as try_emplace, the key is moved into the new node.
+	*/
+	template<typename... Args>
+	std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args);
+	/**
+	* Functionallity: Inserts the element or overwrites the info of the existing one.
+	* Outputs an iterator to the element and true if the element was inserted.
+	* param[in] key : Key of the element.
+	* param[in] info : Info that is going to be stored under the key.
+	*/
+	std::pair<iterator, bool> insert_or_assign(const Key& key, const Info& info);
+	/**
+	* Functionallity: Finds or inserts (with a value initialized Info) the element and applies method to its info.
+	* Approche: Single descent, so counting words is simply:
+	* d.upsert(word, [](int& count) { ++count; });
+	* Outputs an iterator to the element and true if the element was inserted.
+	* param[in] key : Key of the element.
+	* param[in] method : Method accepting Info& which updates the info.
+	*/
+	template<typename Update>
+	std::pair<iterator, bool> upsert(const Key& key, Update method);
+	/**
+	* Functionallity: Same as upsert, available with a transparent Compare. The key is built from key only when the element is inserted,
+	* so counting words from std::string_view tokens does not allocate for words which are already in the tree.
+	*/
+	template<typename K, typename Update, typename C = Compare, typename = typename C::is_transparent>
+	std::pair<iterator, bool> upsert(const K& key, Update method);
+	/**
 	* Functionality: Delete the node from the AVL tree.
-	* Approche: I am using recursive remove. There is possible throw when key is not a memeber of the tree, however, public method outputs true/false in that case.
+	* Approche: I am using iterative remove, the nodes are relinked and the tree is rebalanced on the way up. When key is not a memeber of the tree nothing is changed and public method outputs false.
 	* param[in] key : Key of the element that is going to be deleted.
 	*/
 	bool remove(const Key& key);
 	/**
+	* Functionality: Unlinks the element from the AVL tree and outputs it as a node handle. No deallocation is made.
+	* If the key is not a member of the tree an empty node handle is being returned.
+	* param[in] key : Key of the element that is going to be extracted.
+	*/
+	node_handle extract(const Key& key);
+	/**
 	* Functionality: Executes set of instruction for all of the nodes of the AVL tree.
 	* Approche: Recursive method executes ToDo method according to the TravelType (preorder by default)
 	* ToDo method do need to have const_iterator to the element at the imput. In order to work properly.
@@ -252,6 +721,52 @@ public:
 	template<typename ToDo>
 	void executeForAllNodes(ToDo method, TravelType type = TravelType::Preorder) const;
 	/**
+	* Functionality: Adds all of the elements of other to the tree. For keys which are in both trees combine(Info& mine, const Info& theirs) is called.
+	* Approche: Join based union, the tree is split by the key of the root of other and both halves are processed recursively
+	* and then joined back. O(m log(n/m + 1)) work where m <= n are the sizes of the trees.
+	* Independent halves are executed on separate threads for big trees (only with stateless allocators),
+	* so combine may be called concurrently for different elements.
+	* param[in] other : Dictionary which elements are added, it is not modified.
+	* param[in] combine : Method merging the infos of the same key.
+	*/
+	template<typename Combine>
+	void union_with(const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& other, Combine combine);
+	/**
+	* Functionality: Same as union_with with combine, but infos of the keys which are already in the tree are kept.
+	*/
+	void union_with(const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& other);
+	/**
+	* Functionality: Removes the elements which keys are not in other. For the remaining ones combine(Info& mine, const Info& theirs) is called.
+	* Approche: Join based, same as union_with. O(m log(n/m + 1)).
+	* param[in] other : Dictionary with the keys to keep, it is not modified.
+	* param[in] combine : Method merging the infos of the same key.
+	*/
+	template<typename Combine>
+	void intersection(const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& other, Combine combine);
+	/**
+	* Functionality: Same as intersection with combine, infos are kept.
+	*/
+	void intersection(const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& other);
+	/**
+	* Functionality: Removes the elements which keys are in other.
+	* Approche: Join based, same as union_with. O(m log(n/m + 1)).
+	* param[in] other : Dictionary with the keys to remove, it is not modified.
+	*/
+	void difference(const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& other);
+	/**
+	* Functionality: Same as union_with, but the nodes of other are moved to the tree instead of being copied, other is left empty.
+	* For keys which are in both trees combine(Info& mine, Info&& theirs) is called.
+	* If the allocators are different the elements are copied.
+	* param[in] other : Dictionary which nodes are taken over.
+	* param[in] combine : Method merging the infos of the same key.
+	*/
+	template<typename Combine>
+	void merge_with(Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& other, Combine combine);
+	/**
+	* Functionality: Same as merge_with with combine, infos of the keys which are already in the tree are kept.
+	*/
+	void merge_with(Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& other);
+	/**
 	* There are also three classic BST traversals.
 	* param[in] type : Travel type.
 	* param[in] out : By default std::cout. Specifies the ostream variable.
@@ -279,49 +794,319 @@ public:
 	* param[in] key : Key to find a value.
 	*/
 	iterator find(const Key& key) const;
+	/**
+	* Same as find, available with a transparent Compare, no Key is built.
+	*/
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator find(const K& key) const;
+	/**
+	* Functionality: Checks whether an element with a given key is a member of the tree.
+	* Approche: Same descent as find. O(logN).
+	* param[in] key : Key to look for.
+	*/
+	bool contains(const Key& key) const;
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	bool contains(const K& key) const;
+	/**
+	* Functionality: Outputs an iterator to the first element which key is not less than a given key.
+	* If there is no such element end() is being returned.
+	* Approche: Single descent from the head remembering the last node that went left. O(logN).
+	* param[in] key : Key to compare with.
+	*/
+	iterator lower_bound(const Key& key) const;
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator lower_bound(const K& key) const;
+	/**
+	* Functionality: Outputs an iterator to the first element which key is greater than a given key.
+	* If there is no such element end() is being returned.
+	* Approche: Same as lower_bound. O(logN).
+	* param[in] key : Key to compare with.
+	*/
+	iterator upper_bound(const Key& key) const;
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator upper_bound(const K& key) const;
+	/**
+	* Functionality: Outputs the range of elements with a given key as a pair of lower_bound and upper_bound.
+	* Keys are unique so the range is either empty or contains exactly one element.
+	* param[in] key : Key to compare with.
+	*/
+	std::pair<iterator, iterator> equal_range(const Key& key) const;
+	/**
+	* Functionality: Outputs a view of the elements which key is in [lo, hi] (both inclusive), empty when hi < lo.
+	* for (auto it : d.range(lo, hi)) ... visits them in order.
+	* Approche: lower_bound(lo) and upper_bound(hi), nothing else is done until the view is iterated. O(logN).
+	* param[in] lo : Lower bound of the keys.
+	* param[in] hi : Upper bound of the keys.
+	*/
+	range_view range(const Key& lo, const Key& hi) const;
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	range_view range(const K& lo, const K& hi) const;
+	/**
+	* Functionality: Outputs a view of the elements which key starts with a given prefix (all of them for an empty prefix),
+	* e.g. the first k completions of a word. Available for keys which convert to std::string_view, the order has to be lexicographic.
+	* Approche: The view begins at lower_bound(prefix) and ends at lower_bound of the smallest string greater than every string
+	* with the prefix (the last byte below 0xff increased by one, the bytes after it cut off), so it stops at the first non-match. O(logN).
+	* With a transparent Compare no Key is built, the bound is a std::string (no allocation for short prefixes).
+	* param[in] text : Prefix of the keys.
+	*/
+	template<typename K = Key, typename = decltype(std::string_view(std::declval<const K&>()))>
+	range_view prefix(std::string_view text) const;
+	/**
+	* Functionality: Calls method(const_iterator&) for every element which key is in [lo, hi], in order.
+	* Approche: Recursive descent which enters only the subtrees overlapping the range. O(logN + k) for k elements.
+	* param[in] lo : Lower bound of the keys.
+	* param[in] hi : Upper bound of the keys.
+	* param[in] method : Method called with every element.
+	*/
+	template<typename ToDo>
+	void visit_range(const Key& lo, const Key& hi, ToDo method) const;
+	template<typename K, typename ToDo, typename C = Compare, typename = typename C::is_transparent>
+	void visit_range(const K& lo, const K& hi, ToDo method) const;
+	/**
+	* Functionality: Outputs an iterator to the k-th smallest element (counting from 0), e.g. select(size() / 2) is the median.
+	* If k >= size() end() is being returned.
+	* Approche: Descent guided by the sizes of the left subtrees. O(logN).
+	* param[in] k : Position of the element in the sorted order.
+	*/
+	iterator select(std::size_t k) const;
+	/**
+	* Functionality: Outputs the number of elements which key is less than a given key,
+	* so for an existing key it is its position in the sorted order (select(rank(key)) == find(key)).
+	* Approche: Single descent summing the sizes of the left subtrees. O(logN).
+	* param[in] key : Key to compare with.
+	*/
+	std::size_t rank(const Key& key) const;
+	/**
+	* Functionality: Outputs the number of elements which key is in [lo, hi] (both inclusive).
+	* Approche: Two descents, no element is visited. O(logN).
+	* param[in] lo : Lower bound of the keys.
+	* param[in] hi : Upper bound of the keys.
+	*/
+	std::size_t count_range(const Key& lo, const Key& hi) const;
+	/**
+	* Functionality: Outputs the aggregate (e.g. SumAggregate) of the elements which key is in [lo, hi] (both inclusive),
+	* identity() when there are none. Available when the Dictionary has an aggregate policy.
+	* Approche: The paths to lo and hi split at one node, below it whole subtrees on the inner sides of the paths
+	* are taken from their cached aggregates, so only O(logN) nodes are combined.
+	* param[in] lo : Lower bound of the keys.
+	* param[in] hi : Upper bound of the keys.
+	*/
+	template<typename A = Aggregate>
+	typename A::value_type aggregate(const Key& lo, const Key& hi) const;
+	/**
+	* Outputs the aggregate of all of the elements in O(1), identity() for an empty tree.
+	*/
+	template<typename A = Aggregate>
+	typename A::value_type aggregate() const;
+	/**
+	* Functionality: Outputs an immutable copy of the tree optimised for lookups, see FrozenDictionary.h.
+	* Approche: Nodes are collected in order and their elements are copied to flat arrays in Eytzinger order. O(n).
+	*/
+	FrozenDictionary<Key, Info, Compare> freeze() const;
+	/**
+	* Functionality: Writes the elements to a binary snapshot file, load reads it back without building the tree from the scratch.
+	* The file has a header (magic, version, number of elements, length of the elements), the keys in sorted order each followed
+	* by its info (Serializer<Key> and Serializer<Info> from Serializer.h, integers are varints) and a checksum of the header and the elements.
+	* If the file can not be written "Could not write the file!" is thrown.
+	* param[in] filename : Name of the file.
+	*/
+	void save(const std::string& filename) const;
+	/**
+	* Functionality: Replaces the content of the tree with a snapshot written by save. When the file can not be read, it is not a snapshot,
+	* it has another version, a wrong length or checksum or more elements than bytes, "Could not open the file!", "Not a dictionary snapshot!", "Unsupported snapshot version!"
+	* or "Snapshot is corrupted!" is thrown and the tree is left untouched.
+	* Approche: The file is read at once and the checksum is checked before anything is decoded. The elements are already sorted,
+	* so they are decoded straight into the nodes of the bulk build (same as assign), O(n) without any rotations.
+	* param[in] filename : Name of the file.
+	*/
+	void load(const std::string& filename);
 };
+/**
+* AVL tree dictionary with an aggregate policy, e.g. AggregateDictionary<std::string, int, SumAggregate<long long>>.
+*/
+template<typename Key, typename Info, typename Aggregate, typename Compare = std::less<Key>, typename Allocator = std::allocator<std::pair<const Key, Info>>>
+using AggregateDictionary = Dictionary<Key, Info, Compare, Allocator, AVLTree, Aggregate>;
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename... Args>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Node* Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::createNode(Args&&... args) {
+	Node* curr = NodeTraits::allocate(alloc, 1);
+	try {
+		NodeTraits::construct(alloc, curr, std::forward<Args>(args)...);
+	}
+	catch (...) {
+		NodeTraits::deallocate(alloc, curr, 1);
+		throw;
+	}
+	return curr;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::destroyNode(Node* curr) {
+	NodeTraits::destroy(alloc, curr);
+	NodeTraits::deallocate(alloc, curr, 1);
+}
+
+namespace DictionaryDetail {
+	/**
+	* Calls alloc.release() if the allocator has it.
+	*/
+	template<typename Alloc>
+	auto release(Alloc& alloc, int) -> decltype(bool(alloc.release())) {
+		return alloc.release();
+	}
+	template<typename Alloc>
+	bool release(Alloc&, long) {
+		return false;
+	}
+	/**
+	* Calls alloc.reserve(count) if the allocator has it.
+	*/
+	template<typename Alloc>
+	auto reserve(Alloc& alloc, std::size_t count, int) -> decltype(void(alloc.reserve(count))) {
+		alloc.reserve(count);
+	}
+	template<typename Alloc>
+	void reserve(Alloc&, std::size_t, long) {}
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+bool Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::releaseAll() {
+	if (std::is_trivially_destructible<Key>::value and std::is_trivially_destructible<Info>::value)
+		return DictionaryDetail::release(alloc, 0);
+	return false;
+}
 
-template<typename Key, typename Info>
-void Dictionary<Key, Info>::clear(Node*& curr)
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::clear(Node*& curr)
 {
-	if (curr) {
-		clear(curr->left);
-		clear(curr->right);
-		delete curr;
-		curr = nullptr;
+	//no recursion, the left child is rotated up until there is none, then the node can be deleted
+	//and we continue with its right subtree, every node is visited a constant number of times
+	Node* cache = curr;
+	while (cache) {
+		if (cache->left) {
+			Node* left = cache->left;
+			cache->left = left->right;
+			left->right = cache;
+			cache = left;
+		}
+		else {
+			Node* right = cache->right;
+			destroyNode(cache);
+			cache = right;
+		}
 	}
+	curr = nullptr;
 }
 
-template<typename Key, typename Info>
-typename Dictionary<Key, Info>::Node* Dictionary<Key, Info>::copy(Node* toCopy, Node* prev) {
-	Node* cache = nullptr;
-	if (toCopy) {
-		cache = new Node(toCopy->m_key, toCopy->m_info, toCopy->height);
-		cache->up = prev;
-		cache->left = copy(toCopy->left, cache);
-		cache->right = copy(toCopy->right, cache);
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Node* Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::copy(Node* toCopy, Node* prev) {
+	if (!toCopy)
+		return nullptr;
+	Node* root = createNode(toCopy->m_key, toCopy->m_info);
+	root->height = toCopy->height;
+	root->size = toCopy->size;
+	copyAggregate(root, toCopy);
+	root->up = prev;
+	//preorder without recursion, dst is always the copy of src
+	Node* src = toCopy;
+	Node* dst = root;
+	try {
+		while (true) {
+			if (src->left and !dst->left) {
+				dst->left = createNode(src->left->m_key, src->left->m_info);
+				dst->left->height = src->left->height;
+				dst->left->size = src->left->size;
+				copyAggregate(dst->left, src->left);
+				dst->left->up = dst;
+				src = src->left;
+				dst = dst->left;
+			}
+			else if (src->right and !dst->right) {
+				dst->right = createNode(src->right->m_key, src->right->m_info);
+				dst->right->height = src->right->height;
+				dst->right->size = src->right->size;
+				copyAggregate(dst->right, src->right);
+				dst->right->up = dst;
+				src = src->right;
+				dst = dst->right;
+			}
+			else if (src == toCopy) {
+				break;
+			}
+			else {
+				src = src->up;
+				dst = dst->up;
+			}
+		}
 	}
-	return cache;
+	catch (...) {
+		clear(root);
+		throw;
+	}
+	return root;
 }
 
-template<typename Key, typename Info>
-int Dictionary<Key, Info>::getHeight(Node* curr) const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+int Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::getHeight(Node* curr) const {
 	if (curr)
 		return curr->height;
 	else
 		return 0;
 }
 
-template<typename Key, typename Info>
-int Dictionary<Key, Info>::getBalance(Node* curr) const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+std::size_t Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::getSize(Node* curr) const {
+	if (curr)
+		return curr->size;
+	else
+		return 0;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::update(Node* curr) {
+	curr->height = std::max(getHeight(curr->left), getHeight(curr->right)) + 1;
+	curr->size = getSize(curr->left) + getSize(curr->right) + 1;
+	updateAggregate(curr);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::updateAggregate(Node* curr) const {
+	if constexpr (!std::is_same<Aggregate, NoAggregate>::value) {
+		Aggregate policy;
+		typename Aggregate::value_type value = policy.value(curr->m_key, curr->m_info);
+		if (curr->left)
+			value = policy.combine(curr->left->aggregate, value);
+		if (curr->right)
+			value = policy.combine(value, curr->right->aggregate);
+		curr->aggregate = value;
+	}
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::refresh(Node* curr) const {
+	if constexpr (!std::is_same<Aggregate, NoAggregate>::value) {
+		for (; curr; curr = curr->up)
+			updateAggregate(curr);
+	}
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::copyAggregate(Node* dst, const Node* src) const {
+	if constexpr (!std::is_same<Aggregate, NoAggregate>::value)
+		dst->aggregate = src->aggregate;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+int Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::getBalance(Node* curr) const {
 	if (curr)
 		return getHeight(curr->left) - getHeight(curr->right);
 	else
 		return 0;
 }
 
-template<typename Key, typename Info>
-typename Dictionary<Key, Info>::Node* Dictionary<Key, Info>::getMinimalValueNode(Node* curr) const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Node* Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::getMinimalValueNode(Node* curr) const {
 	Node* cache = curr;
 	if (cache)
 		while (cache->left)
@@ -329,8 +1114,8 @@ typename Dictionary<Key, Info>::Node* Dictionary<Key, Info>::getMinimalValueNode
 	return cache;
 }
 
-template<typename Key, typename Info>
-typename Dictionary<Key, Info>::Node* Dictionary<Key, Info>::getMaximalValueNode(Node* curr) const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Node* Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::getMaximalValueNode(Node* curr) const {
 	Node* cache = curr;
 	if (cache)
 		while (cache->right)
@@ -338,8 +1123,8 @@ typename Dictionary<Key, Info>::Node* Dictionary<Key, Info>::getMaximalValueNode
 	return cache;
 }
 
-template<typename Key, typename Info>
-void Dictionary<Key, Info>::leftRotate(Node*& A) {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::leftRotate(Node*& A) {
 	Node* B = A->right;
 	Node* x1 = B->left;
 	//rotation
@@ -349,15 +1134,15 @@ void Dictionary<Key, Info>::leftRotate(Node*& A) {
 	A->right = x1;
 	if (x1)
 		x1->up = A;
-	//new heights
-	A->height = std::max(getHeight(A->left), getHeight(A->right)) + 1;
-	B->height = std::max(getHeight(B->left), getHeight(B->right)) + 1;
+	//new heights and sizes
+	update(A);
+	update(B);
 	//update the A
 	A = B;
 }
 
-template<typename Key, typename Info>
-void Dictionary<Key, Info>::rightRotate(Node*& A) {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::rightRotate(Node*& A) {
 	Node* B = A->left;
 	Node* x1 = B->right;
 	//rotation
@@ -367,171 +1152,267 @@ void Dictionary<Key, Info>::rightRotate(Node*& A) {
 	A->left = x1;
 	if (x1)
 		x1->up = A;
-	//new heights
-	A->height = std::max(getHeight(A->left), getHeight(A->right)) + 1;
-	B->height = std::max(getHeight(B->left), getHeight(B->right)) + 1;
+	//new heights and sizes
+	update(A);
+	update(B);
 	//update the A
 	A = B;
 }
 
-template<typename Key, typename Info>
-void Dictionary<Key, Info>::insert(Node*& curr, const Key& key, const Info& info, Node*& newNode) {
-	//We do need to insert the node and balance the tree.
-	if (!curr) {
-		curr = new Node(key, info);
-		newNode = curr;
-		return;
-	}
-	if (curr->m_key == key) {
-		newNode = curr;
-		throw false;
-	}	
-	if (curr->m_key < key) {
-		if (!curr->right) {
-			insert(curr->right, key, info, newNode);
-			curr->right->up = curr;
-		}
-		else {
-			insert(curr->right, key, info, newNode);
-		}
-		//firstly we need to update the height of a current node
-		curr->height = std::max(getHeight(curr->left), getHeight(curr->right)) + 1;
-		//then we calculate the balance factor of the curr node
-		int balance = getBalance(curr);
-		//Right-right case.
-		if (balance < -1 and key > curr->right->m_key) {
-			leftRotate(curr);
-			return;
-		}
-		//Right-left case.
-		if (balance < -1 and key < curr->right->m_key) {
-			rightRotate(curr->right);
-			leftRotate(curr);
-			return;
-		}
-	}
-	else if (curr->m_key > key) {
-		if (!curr->left) {
-			insert(curr->left, key, info, newNode);
-			curr->left->up = curr;
-		}
-		else {
-			insert(curr->left, key, info, newNode);
-		}
-		//firstly we need to update the height of a current node
-		curr->height = std::max(getHeight(curr->left), getHeight(curr->right)) + 1;
-		//then we calculate the balance factor of the curr node
-		int balance = getBalance(curr);
-		//Left-left case.
-		if (balance > 1 and key < curr->left->m_key) {
-			rightRotate(curr);
-			return;
-		}
-		//Left-right
-		if (balance > 1 and key > curr->left->m_key) {
-			leftRotate(curr->left);
-			rightRotate(curr);
-			return;
-		}
-	}
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Node*& Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::link(Node* curr) {
+	if (!curr->up)
+		return head;
+	if (curr->up->left == curr)
+		return curr->up->left;
+	return curr->up->right;
 }
 
-template<typename Key, typename Info>
-typename Dictionary<Key, Info>::Node* Dictionary<Key, Info>::remove(Node* curr, const Key& key) {
-	//simple way of finding a node.
-	if (!curr)
-		throw false;
-	if (curr->m_key > key)
-		curr->left = remove(curr->left, key);
-	else if (curr->m_key < key)
-		curr->right = remove(curr->right, key);
-	else {
-		//if the node has only one child we can simply delete it like that:
-		if (curr->left == nullptr or curr->right == nullptr) {
-			Node* cache = nullptr;
-			if (curr->left)
-				cache = curr->left;
-			else
-				cache = curr->right;
-			//when node has no child case(1)
-			if (!cache) {
-				cache = curr;
-				//curr will simple be a nullptr
-				curr = nullptr;
-			}
-			else { //case(2)
-				//if there is a child we do need to copy the content of cache to curr
-				curr->m_key = cache->m_key; curr->m_info = cache->m_info;
-				curr->left = nullptr; curr->right = nullptr;
-			}
-			delete cache;
-		}
-		else {  //case(3)	
-			//otherwise we do need to find a minimal node of the right subtree
-			Node* cache = getMinimalValueNode(curr->right);
-			//current node becames the minimal node of the right subtree
-			curr->m_key = cache->m_key; curr->m_info = cache->m_info;
-			//the problem here is that we do need to delete the cache node
-			//currently we do have 2 nodes with cache in it 
-			//unfortunately to delete the cache we need to inform the parent
-			//the easiest way to do this is to run the remove method again and simply delete the
-			//cache key
-			curr->right = remove(curr->right, cache->m_key);
-		}
-	}
-	//we do need to make sure that curr exist
-	if (!curr)
-		return nullptr;
-	//after deleting we do need to update the height and obtain a new balance
-	curr->height = 1 + std::max(getHeight(curr->left), getHeight(curr->right));
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Node* Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::rebalance(Node* curr) {
+	//firstly we need to update the height (and size) of a current node
+	update(curr);
+	//then we calculate the balance factor of the curr node
 	int balance = getBalance(curr);
 	//finally we do need to rebalance the tree if it is necessary
 	if (balance > 1 and //as always we do need to balance if balance factor > 1 or < 1
 		getBalance(curr->left) >= 0) {
 		//left-left case bacause left subtree balance is >= 0
 		rightRotate(curr);
-		return curr;
 	}
 	else if (balance > 1 and getBalance(curr->left) < 0) {
 		//left-right case bacause left subtree balance is < 0 (right subtree of the left subtree is grater)
 		leftRotate(curr->left);
 		rightRotate(curr);
-		return curr;
 	}
 	else if (balance < -1 and getBalance(curr->right) <= 0) {
 		//right-right case bacause (same as prev) plus balance is negative
 		leftRotate(curr);
-		return curr;
 	}
 	else if (balance < -1 and getBalance(curr->right) > 0) {
 		//right-left case (same as before)
 		rightRotate(curr->right);
 		leftRotate(curr);
-		return curr;
 	}
-	else {
-		//if there are no roatations we simply output curr node.
-		return curr;
+	//if there are no roatations we simply output curr node.
+	return curr;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::retrace(Node* curr) {
+	while (curr) {
+		int height = curr->height;
+		Node*& parentLink = link(curr);
+		parentLink = rebalance(curr);
+		curr = parentLink->up;
+		//after insert it stops at the first rotation, after remove it may go up to the head
+		if (parentLink->height == height)
+			break;
+	}
+	//heights above are fine, but the sizes (and aggregates) of all ancestors have changed
+	while (curr) {
+		curr->size = getSize(curr->left) + getSize(curr->right) + 1;
+		updateAggregate(curr);
+		curr = curr->up;
+	}
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename K, typename Make>
+bool Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::insert(const K& key, Node*& newNode, Make make) {
+	//We do need to find the place of the node, there is no recursion so we only go down once
+	Node* parent = nullptr;
+	Node* curr = head;
+	bool left = false;
+	while (curr) {
+		parent = curr;
+		int order = DictionaryDetail::compareKeys(comp, key, curr->m_key, 0);
+		if (order < 0) {
+			curr = curr->left;
+			left = true;
+		}
+		else if (order > 0) {
+			curr = curr->right;
+			left = false;
+		}
+		else {
+			newNode = curr;
+			//nothing has changed so there is no need to rebalance anything
+			return false;
+		}
+	}
+	newNode = make();
+	newNode->up = parent;
+	updateAggregate(newNode);
+	if (!parent)
+		head = newNode;
+	else if (left)
+		parent->left = newNode;
+	else
+		parent->right = newNode;
+	//then we go up and balance the tree
+	retrace(parent);
+	return true;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Node* Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::unlink(const Key& key) {
+	Node* curr = search(key);
+	if (!curr)
+		return nullptr;
+	//the node from which the tree has to be rebalanced
+	Node* changed = nullptr;
+	//if the node has only one child we can simply replace the node with it case(1)(2)
+	if (curr->left == nullptr or curr->right == nullptr) {
+		Node* cache = curr->left ? curr->left : curr->right;
+		if (cache)
+			cache->up = curr->up;
+		changed = curr->up;
+		link(curr) = cache;
+	}
+	else {  //case(3)
+		//otherwise we do need to unlink a minimal node of the right subtree
+		//and put it in the place of the current node, so the nodes themselves are not copied
+		Node* cache = getMinimalValueNode(curr->right);
+		if (cache->up == curr) {
+			//cache is the right child, it keeps its right subtree
+			changed = cache;
+		}
+		else {
+			//cache is replaced by its right child (it cannot have the left one)
+			changed = cache->up;
+			changed->left = cache->right;
+			if (cache->right)
+				cache->right->up = changed;
+			cache->right = curr->right;
+			cache->right->up = cache;
+		}
+		cache->left = curr->left;
+		cache->left->up = cache;
+		cache->up = curr->up;
+		cache->height = curr->height;
+		cache->size = curr->size;
+		link(curr) = cache;
+	}
+	retrace(changed);
+	return curr;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Node* Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::build(Node** nodes, std::size_t count, Node* prev) {
+	if (!count)
+		return nullptr;
+	//the middle element becomes the root, so sizes (and heights) of the subtrees differ by at most 1
+	std::size_t middle = count / 2;
+	Node* curr = nodes[middle];
+	curr->up = prev;
+	curr->left = build(nodes, middle, curr);
+	curr->right = build(nodes + middle + 1, count - middle - 1, curr);
+	update(curr);
+	return curr;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename It>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::assignSorted(It first, It last) {
+	std::vector<Node*> nodes;
+	try {
+		for (; first != last; ++first) {
+			nodes.push_back(nullptr);
+			auto&& element = *first;
+			nodes.back() = createNode(std::get<0>(std::forward<decltype(element)>(element)), std::get<1>(std::forward<decltype(element)>(element)));
+			if (nodes.size() > 1 and !comp(nodes[nodes.size() - 2]->m_key, nodes.back()->m_key))
+				throw "Range is not sorted!";
+		}
+	}
+	catch (...) {
+		//the tree is not touched until all of the nodes are there
+		for (Node* node : nodes)
+			if (node)
+				destroyNode(node);
+		throw;
+	}
+	//the old nodes are destroyed one by one, releasing the whole pool would free the new nodes as well
+	clear(head);
+	head = build(nodes.data(), nodes.size(), nullptr);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename It>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::assign(It first, It last) {
+	assignSorted(first, last);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename It, typename Combine>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::assign(It first, It last, Combine combine) {
+	std::vector<std::pair<Key, Info>> elements;
+	for (; first != last; ++first)
+		elements.emplace_back(std::get<0>(*first), std::get<1>(*first));
+	//stable sort keeps the order of appearance of the same keys
+	std::stable_sort(elements.begin(), elements.end(),
+		[this](const std::pair<Key, Info>& a, const std::pair<Key, Info>& b)->bool
+		{
+			return comp(a.first, b.first);
+		});
+	//merging the duplicates in place
+	std::size_t unique = 0;
+	for (std::size_t i = 0; i < elements.size(); i++) {
+		if (unique and !comp(elements[unique - 1].first, elements[i].first)) {
+			combine(elements[unique - 1].second, std::move(elements[i].second));
+		}
+		else {
+			if (unique != i)
+				elements[unique] = std::move(elements[i]);
+			unique++;
+		}
 	}
+	elements.erase(elements.begin() + unique, elements.end());
+	assignSorted(std::make_move_iterator(elements.begin()), std::make_move_iterator(elements.end()));
 }
 
-template<typename Key, typename Info>
-bool Dictionary<Key, Info>::compareNodes(Node* a, Node* b) const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+bool Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::compareNodes(Node* a, Node* b) const {
 	if (a == b)
 		return true;
 	if (a == nullptr)
 		return false;
 	if (b == nullptr)
 		return false;
-	return (a->m_key == b->m_key) and
-		(a->m_info == b->m_info) and
-		compareNodes(a->right, b->right) and
-		compareNodes(a->left, b->left);
+	//preorder traversal of a, b follows exactly the same path
+	//from is the previously visited node so we know whether we came from the parent or from a child
+	Node* x = a;
+	Node* y = b;
+	Node* from = a->up;
+	while (true) {
+		if (from == x->up) {
+			//first visit of x
+			if (!(x->m_key == y->m_key) or !(x->m_info == y->m_info) or
+				(x->left == nullptr) != (y->left == nullptr) or (x->right == nullptr) != (y->right == nullptr))
+				return false;
+			if (x->left) {
+				from = x; x = x->left; y = y->left;
+				continue;
+			}
+			if (x->right) {
+				from = x; x = x->right; y = y->right;
+				continue;
+			}
+		}
+		else if (from == x->left and x->right) {
+			from = x; x = x->right; y = y->right;
+			continue;
+		}
+		//both subtrees are done
+		if (x == a)
+			return true;
+		from = x; x = x->up; y = y->up;
+	}
 }
 
-template<typename Key, typename Info>
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
 template<typename ToDo>
-void Dictionary<Key, Info>::uniTraversal(Node* curr, ToDo method, const TravelType type) const {
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::uniTraversal(Node* curr, ToDo method, const TravelType type) const {
 	if (curr) {
 		if (type == TravelType::Preorder) {
 			method(const_iterator(curr, this));
@@ -547,27 +1428,27 @@ void Dictionary<Key, Info>::uniTraversal(Node* curr, ToDo method, const TravelTy
 	}
 }
 
-template<typename Key, typename Info>
-Dictionary<Key, Info>::iterator::iterator(Node* x, const Dictionary<Key, Info>* m) : master(m), curr(x) {}
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator::iterator(Node* x, const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>* m) : master(m), curr(x) {}
 
-template<typename Key, typename Info>
-Dictionary<Key, Info>::iterator::iterator() : master(nullptr), curr(nullptr) {}
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator::iterator() : master(nullptr), curr(nullptr) {}
 
-template<typename Key, typename Info>
-Dictionary<Key, Info>::iterator::iterator(const iterator& x) : master(x.master), curr(x.curr) {}
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator::iterator(const iterator& x) : master(x.master), curr(x.curr) {}
 
-template<typename Key, typename Info>
-bool Dictionary<Key, Info>::iterator::operator==(const iterator& x) const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+bool Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator::operator==(const iterator& x) const {
 	return curr == x.curr and master == x.master;
 }
 
-template<typename Key, typename Info>
-bool Dictionary<Key, Info>::iterator::operator!=(const iterator& x) const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+bool Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator::operator!=(const iterator& x) const {
 	return curr != x.curr or master != x.master;
 }
 
-template<typename Key, typename Info>
-const typename Dictionary<Key, Info>::iterator& Dictionary<Key, Info>::iterator::operator++() const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+const typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator& Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator::operator++() const {
 	if (!master) {
 		throw "Master does not exist!";
 	}
@@ -602,15 +1483,15 @@ const typename Dictionary<Key, Info>::iterator& Dictionary<Key, Info>::iterator:
 	return *this;
 }
 
-template<typename Key, typename Info>
-typename Dictionary<Key, Info>::iterator Dictionary<Key, Info>::iterator::operator++(int) const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator::operator++(int) const {
 	iterator cache(*this);
 	operator++();
 	return cache;
 }
 
-template<typename Key, typename Info>
-const typename Dictionary<Key, Info>::iterator& Dictionary<Key, Info>::iterator::operator--() const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+const typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator& Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator::operator--() const {
 	if (!master) {
 		throw "Master does not exist!";
 	}
@@ -645,201 +1526,414 @@ const typename Dictionary<Key, Info>::iterator& Dictionary<Key, Info>::iterator:
 	return *this;
 }
 
-template<typename Key, typename Info>
-typename Dictionary<Key, Info>::iterator Dictionary<Key, Info>::iterator::operator--(int) const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator::operator--(int) const {
 	iterator cache(*this);
 	operator--();
 	return cache;
 }
 
-template<typename Key, typename Info>
-const Info& Dictionary<Key, Info>::iterator::operator*() const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+const Info& Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator::operator*() const {
 	if (!curr)
 		throw "Iterator does not have a value!";
 	return curr->m_info;
 }
 
-template<typename Key, typename Info>
-Info& Dictionary<Key, Info>::iterator::operator*() {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator::reference Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator::operator*() {
 	if (!curr)
 		throw "Iterator does not have a value!";
 	return curr->m_info;
 }
 
-template<typename Key, typename Info>
-const Key& Dictionary<Key, Info>::iterator::getKey() const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename Update>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator::modify(Update method) {
+	if (!curr)
+		throw "Iterator does not have a value!";
+	method(curr->m_info);
+	master->refresh(curr);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+const Key& Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator::getKey() const {
 	if (!curr)
 		throw "Iterator does not have a value!";
 	return curr->m_key;
 }
 
-template<typename Key, typename Info>
-const Info& Dictionary<Key, Info>::iterator::getInfo() const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+const Info& Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator::getInfo() const {
 	if (!curr)
 		throw "Iterator does not have a value!";
 	return curr->m_info;
 }
 
-template<typename Key, typename Info>
-bool Dictionary<Key, Info>::iterator::isNull() const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+bool Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator::isNull() const {
 	return !curr;
 }
 
-template<typename Key, typename Info>
-Dictionary<Key, Info>::reverse_iterator::reverse_iterator(Node* x, const Dictionary<Key, Info>* m) : iterator(x, m) {}
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::reverse_iterator::reverse_iterator(Node* x, const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>* m) : iterator(x, m) {}
 
-template<typename Key, typename Info>
-Dictionary<Key, Info>::reverse_iterator::reverse_iterator() : iterator() {}
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::reverse_iterator::reverse_iterator() : iterator() {}
 
-template<typename Key, typename Info>
-Dictionary<Key, Info>::reverse_iterator::reverse_iterator(const reverse_iterator& x) : iterator(x.curr, x.master) {}
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::reverse_iterator::reverse_iterator(const reverse_iterator& x) : iterator(x.curr, x.master) {}
 
-template<typename Key, typename Info>
-const typename Dictionary<Key, Info>::reverse_iterator& Dictionary<Key, Info>::reverse_iterator::operator++() const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+const typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::reverse_iterator& Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::reverse_iterator::operator++() const {
 	iterator::operator--();
 	return *this;
 }
 
-template<typename Key, typename Info>
-typename Dictionary<Key, Info>::reverse_iterator Dictionary<Key, Info>::reverse_iterator::operator++(int) const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::reverse_iterator Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::reverse_iterator::operator++(int) const {
 	reverse_iterator cache(*this);
 	iterator::operator--();
 	return cache;
 }
 
-template<typename Key, typename Info>
-const typename Dictionary<Key, Info>::reverse_iterator& Dictionary<Key, Info>::reverse_iterator::operator--() const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+const typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::reverse_iterator& Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::reverse_iterator::operator--() const {
 	iterator::operator++();
 	return *this;
 }
 
-template<typename Key, typename Info>
-typename Dictionary<Key, Info>::reverse_iterator Dictionary<Key, Info>::reverse_iterator::operator--(int) const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::reverse_iterator Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::reverse_iterator::operator--(int) const {
 	reverse_iterator cache(*this);
 	iterator::operator++();
 	return cache;
 }
 
-template<typename Key, typename Info>
-typename Dictionary<Key, Info>::iterator Dictionary<Key, Info>::begin() const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::node_handle::node_handle(Node* x, const NodeAllocator& a) : node(x), alloc(a) {}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::node_handle::node_handle() : node(nullptr), alloc() {}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::node_handle::node_handle(node_handle&& x) noexcept : node(x.node), alloc(std::move(x.alloc)) {
+	x.node = nullptr;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::node_handle::~node_handle() {
+	reset();
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::node_handle::reset() {
+	if (node) {
+		NodeTraits::destroy(alloc, node);
+		NodeTraits::deallocate(alloc, node, 1);
+		node = nullptr;
+	}
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::node_handle& Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::node_handle::operator=(node_handle&& x) noexcept {
+	if (this != &x) {
+		reset();
+		node = x.node;
+		alloc = std::move(x.alloc);
+		x.node = nullptr;
+	}
+	return *this;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+bool Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::node_handle::empty() const {
+	return !node;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+Key& Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::node_handle::key() const {
+	if (!node)
+		throw "Node handle is empty!";
+	return node->m_key;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+Info& Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::node_handle::info() const {
+	if (!node)
+		throw "Node handle is empty!";
+	return node->m_info;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::begin() const {
 	return iterator(getMinimalValueNode(head), this);
 }
 
-template<typename Key, typename Info>
-typename Dictionary<Key, Info>::iterator Dictionary<Key, Info>::end() const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::end() const {
 	return iterator(nullptr, this);
 }
 
-template<typename Key, typename Info>
-typename Dictionary<Key, Info>::reverse_iterator Dictionary<Key, Info>::rbegin() const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::reverse_iterator Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::rbegin() const {
 	return reverse_iterator(getMaximalValueNode(head), this);
 }
 
-template<typename Key, typename Info>
-typename Dictionary<Key, Info>::reverse_iterator Dictionary<Key, Info>::rend() const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::reverse_iterator Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::rend() const {
 	return reverse_iterator(nullptr, this);
 }
 
-template<typename Key, typename Info>
-Dictionary<Key, Info>::Dictionary() : head(nullptr)
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Dictionary() : head(nullptr), alloc(), comp()
+{}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Dictionary(const Allocator& a) : head(nullptr), alloc(a), comp()
+{}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Dictionary(const Compare& c, const Allocator& a) : head(nullptr), alloc(a), comp(c)
 {}
 
-template<typename Key, typename Info>
-Dictionary<Key, Info>::Dictionary(const Dictionary<Key, Info>& x) : head(nullptr)
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename It>
+Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Dictionary(It first, It last, const Allocator& a) : head(nullptr), alloc(a), comp()
+{
+	assignSorted(first, last);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Dictionary(const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& x) : head(nullptr),
+	alloc(NodeTraits::select_on_container_copy_construction(x.alloc)), comp(x.comp)
 {
 	head = copy(x.head);
 }
 
-template<typename Key, typename Info>
-Dictionary<Key, Info>::~Dictionary()
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Dictionary(Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>&& x) noexcept : head(x.head), alloc(std::move(x.alloc)), comp(x.comp)
 {
-	clear(head);
+	x.head = nullptr;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::~Dictionary()
+{
+	clear();
 }
 
-template<typename Key, typename Info>
-int Dictionary<Key, Info>::getHeight() const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+int Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::getHeight() const {
 	return getHeight(head);
 }
 
-template<typename Key, typename Info>
-bool Dictionary<Key, Info>::empty() const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+std::size_t Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::size() const {
+	return getSize(head);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+bool Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::empty() const {
 	return head == nullptr;
 }
 
-template<typename Key, typename Info>
-void Dictionary<Key, Info>::clear() {
-	clear(head);
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::clear() {
+	//when there is nothing to destroy the pool can simply drop all of its chunks
+	if (head and releaseAll())
+		head = nullptr;
+	else
+		clear(head);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::reserve(std::size_t count) {
+	DictionaryDetail::reserve(alloc, count, 0);
 }
 
-template<typename Key, typename Info>
-Dictionary<Key, Info>& Dictionary<Key, Info>::operator=(const Dictionary<Key, Info>& x) {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::operator=(const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& x) {
 	if (this != &x) {
-		clear(head);
+		clear();
+		comp = x.comp;
 		head = copy(x.head);
 	}
 	return *this;
 };
 
-template<typename Key, typename Info>
-bool Dictionary<Key, Info>::operator==(const Dictionary<Key, Info>& x) const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::operator=(Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>&& x)
+	noexcept(NodeTraits::propagate_on_container_move_assignment::value or NodeTraits::is_always_equal::value) {
+	if (this != &x) {
+		clear();
+		comp = x.comp;
+		if (NodeTraits::propagate_on_container_move_assignment::value) {
+			alloc = std::move(x.alloc);
+		}
+		else if (alloc != x.alloc) {
+			//we cannot take over the nodes of a different allocator, so they are copied
+			head = copy(x.head);
+			x.clear();
+			return *this;
+		}
+		head = x.head;
+		x.head = nullptr;
+	}
+	return *this;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+bool Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::operator==(const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& x) const {
 	return compareNodes(head, x.head);
 };
 
-template<typename Key, typename Info>
-bool Dictionary<Key, Info>::operator!=(const Dictionary<Key, Info>& x) const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+bool Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::operator!=(const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& x) const {
 	return !(*this == x);
 };
 
-template<typename Key, typename Info>
-bool Dictionary<Key, Info>::insert(const Key& key, const Info& info)
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+bool Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::insert(const Key& key, const Info& info)
 {
-	try {
-		Node* node;
-		insert(head, key, info, node);
-	}
-	catch (...) {
-		//element already in the tree.
-		return false;
-	}
-	return true;
+	Node* node;
+	return insert(key, node, [&]() { return createNode(key, info); });
 }
 
-template<typename Key, typename Info>
-bool Dictionary<Key, Info>::insert(const Key& key, const Info& info, iterator& it)
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+bool Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::insert(const Key& key, const Info& info, iterator& it)
 {
 	Node* node = nullptr;
-	try {
-		insert(head, key, info, node);
-	}
-	catch (...) {
-		//element already in the tree.
-		it = iterator(node, this);
-		return false;
-	}
+	bool inserted = insert(key, node, [&]() { return createNode(key, info); });
+	//node points either to the new element or to the existing one
 	it = iterator(node, this);
-	return true;
+	return inserted;
 }
 
-template<typename Key, typename Info>
-bool Dictionary<Key, Info>::remove(const Key& key) {
-	try {
-		head = remove(head, key);
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+bool Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::insert(Key&& key, Info&& info)
+{
+	Node* node;
+	return insert(key, node, [&]() { return createNode(std::move(key), std::move(info)); });
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+std::pair<typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator, bool> Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::insert(node_handle&& x)
+{
+	if (x.empty())
+		return std::pair<iterator, bool>(end(), false);
+	Node* node = nullptr;
+	bool inserted = insert(x.node->m_key, node, [this, &x]() {
+		//the handle gives up the ownership only when the node is actually linked
+		if (alloc != x.alloc) {
+			//the node comes from a different allocator so we cannot take it over
+			Node* cache = createNode(std::move(x.node->m_key), std::move(x.node->m_info));
+			x.reset();
+			return cache;
+		}
+		Node* cache = x.node;
+		x.node = nullptr;
+		return cache;
+	});
+	return std::pair<iterator, bool>(iterator(node, this), inserted);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename... Args>
+std::pair<typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator, bool> Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::emplace(Args&&... args)
+{
+	Node* cache = createNode(std::forward<Args>(args)...);
+	Node* node = nullptr;
+	bool inserted = insert(cache->m_key, node, [cache]() { return cache; });
+	if (!inserted)
+		destroyNode(cache);
+	return std::pair<iterator, bool>(iterator(node, this), inserted);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename... Args>
+std::pair<typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator, bool> Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::try_emplace(const Key& key, Args&&... args)
+{
+	Node* node = nullptr;
+	bool inserted = insert(key, node, [&]() { return createNode(key, std::forward<Args>(args)...); });
+	return std::pair<iterator, bool>(iterator(node, this), inserted);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename... Args>
+std::pair<typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator, bool> Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::try_emplace(Key&& key, Args&&... args)
+{
+	Node* node = nullptr;
+	bool inserted = insert(key, node, [&]() { return createNode(std::move(key), std::forward<Args>(args)...); });
+	return std::pair<iterator, bool>(iterator(node, this), inserted);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+std::pair<typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator, bool> Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::insert_or_assign(const Key& key, const Info& info)
+{
+	Node* node = nullptr;
+	bool inserted = insert(key, node, [&]() { return createNode(key, info); });
+	if (!inserted) {
+		node->m_info = info;
+		refresh(node);
 	}
-	catch (...) {
-		//element not found
+	return std::pair<iterator, bool>(iterator(node, this), inserted);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename Update>
+std::pair<typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator, bool> Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::upsert(const Key& key, Update method)
+{
+	Node* node = nullptr;
+	//a new element starts with a value initialized Info, so for counters it is 0
+	bool inserted = insert(key, node, [&]() { return createNode(key); });
+	method(node->m_info);
+	refresh(node);
+	return std::pair<iterator, bool>(iterator(node, this), inserted);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename K, typename Update, typename C, typename>
+std::pair<typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator, bool> Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::upsert(const K& key, Update method)
+{
+	Node* node = nullptr;
+	//the Key is built only for a new node
+	bool inserted = insert(key, node, [&]() { return createNode(key); });
+	method(node->m_info);
+	refresh(node);
+	return std::pair<iterator, bool>(iterator(node, this), inserted);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+bool Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::remove(const Key& key) {
+	Node* removed = unlink(key);
+	if (!removed)
 		return false;
-	}
+	destroyNode(removed);
 	return true;
 }
 
-template<typename Key, typename Info>
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::node_handle Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::extract(const Key& key) {
+	Node* removed = unlink(key);
+	if (removed) {
+		//the node is not a part of the tree anymore
+		removed->left = nullptr;
+		removed->right = nullptr;
+		removed->up = nullptr;
+		update(removed);
+	}
+	return node_handle(removed, alloc);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
 template<typename ToDo>
-void Dictionary<Key, Info>::executeForAllNodes(ToDo method, Dictionary<Key, Info>::TravelType type) const {
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::executeForAllNodes(ToDo method, Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::TravelType type) const {
 	uniTraversal(head, method, type);
 }
 
-template<typename Key, typename Info>
-void Dictionary<Key, Info>::traversal(const TravelType type, std::ostream& out) const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::traversal(const TravelType type, std::ostream& out) const {
 	uniTraversal(head,
 		[&out](Node* curr)->void
 		{
@@ -848,8 +1942,8 @@ void Dictionary<Key, Info>::traversal(const TravelType type, std::ostream& out)
 		type);
 }
 
-template<typename Key, typename Info>
-void Dictionary<Key, Info>::preorder(std::ostream& out) const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::preorder(std::ostream& out) const {
 	uniTraversal(head,
 		[&out](const_iterator& curr)->void
 		{
@@ -858,8 +1952,8 @@ void Dictionary<Key, Info>::preorder(std::ostream& out) const {
 		TravelType::Preorder);
 }
 
-template<typename Key, typename Info>
-void Dictionary<Key, Info>::inorder(std::ostream& out) const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::inorder(std::ostream& out) const {
 	uniTraversal(head,
 		[&out](const_iterator& curr)->void
 		{
@@ -868,8 +1962,8 @@ void Dictionary<Key, Info>::inorder(std::ostream& out) const {
 		TravelType::Inorder);
 }
 
-template<typename Key, typename Info>
-void Dictionary<Key, Info>::postorder(std::ostream& out) const {
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::postorder(std::ostream& out) const {
 	uniTraversal(head,
 		[&out](const_iterator& curr)->void
 		{
@@ -878,24 +1972,651 @@ void Dictionary<Key, Info>::postorder(std::ostream& out) const {
 		TravelType::Postorder);
 }
 
-template<typename Key, typename Info>
-typename Dictionary<Key, Info>::iterator Dictionary<Key, Info>::find(const Key& key) const {
-	iterator x;
-	try {
-		uniTraversal(head,
-			[&x, key](const_iterator& node)
-			{
-				//we do not want to access an empty node.
-				if (!node.isNull()) {
-					if (node.getKey() == key) {
-						x = node;
-						//a simple way to stop the recursion
-						throw true;
-					}
-				}
-			},
-			TravelType::Preorder);
-	}//we do not need to do anything in case of catching an exception
-	catch (...) {}
-	return x;
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename K>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Node* Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::search(const K& key) const {
+	Node* curr = head;
+	//classic BST search, the tree is ordered so we only need to go down one path
+	while (curr) {
+		int order = DictionaryDetail::compareKeys(comp, key, curr->m_key, 0);
+		if (order < 0)
+			curr = curr->left;
+		else if (order > 0)
+			curr = curr->right;
+		else
+			return curr;
+	}
+	return nullptr;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename K>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Node* Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::lowerBound(const K& key) const {
+	Node* curr = head;
+	Node* result = nullptr;
+	while (curr) {
+		if (!comp(curr->m_key, key)) {
+			//curr is a candidate, but there may be a smaller one in the left subtree
+			result = curr;
+			curr = curr->left;
+		}
+		else {
+			curr = curr->right;
+		}
+	}
+	return result;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename K>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Node* Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::upperBound(const K& key) const {
+	Node* curr = head;
+	Node* result = nullptr;
+	while (curr) {
+		if (comp(key, curr->m_key)) {
+			result = curr;
+			curr = curr->left;
+		}
+		else {
+			curr = curr->right;
+		}
+	}
+	return result;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::find(const Key& key) const {
+	Node* curr = search(key);
+	return curr ? iterator(curr, this) : iterator();
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename K, typename C, typename>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::find(const K& key) const {
+	Node* curr = search(key);
+	return curr ? iterator(curr, this) : iterator();
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+bool Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::contains(const Key& key) const {
+	return !find(key).isNull();
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename K, typename C, typename>
+bool Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::contains(const K& key) const {
+	return search(key) != nullptr;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::lower_bound(const Key& key) const {
+	return iterator(lowerBound(key), this);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename K, typename C, typename>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::lower_bound(const K& key) const {
+	return iterator(lowerBound(key), this);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::upper_bound(const Key& key) const {
+	return iterator(upperBound(key), this);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename K, typename C, typename>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::upper_bound(const K& key) const {
+	return iterator(upperBound(key), this);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+std::pair<typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator, typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator> Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::equal_range(const Key& key) const {
+	iterator first = lower_bound(key);
+	iterator second(first);
+	//keys are unique so if the lower bound matches the upper bound is simply its successor
+	if (!first.isNull() and !comp(key, first.getKey()))
+		++second;
+	return std::pair<iterator, iterator>(first, second);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::range_view::range_view(const iterator& first, const iterator& last) : first(first), last(last) {}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::range_view::begin() const {
+	return first;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::range_view::end() const {
+	return last;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+bool Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::range_view::empty() const {
+	return first == last;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::range_view Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::range(const Key& lo, const Key& hi) const {
+	//with hi < lo the upper bound would be before the lower one
+	if (comp(hi, lo))
+		return range_view(end(), end());
+	return range_view(iterator(lowerBound(lo), this), iterator(upperBound(hi), this));
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename K, typename C, typename>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::range_view Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::range(const K& lo, const K& hi) const {
+	if (comp(hi, lo))
+		return range_view(end(), end());
+	return range_view(iterator(lowerBound(lo), this), iterator(upperBound(hi), this));
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename K, typename>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::range_view Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::prefix(std::string_view text) const {
+	//the smallest string greater than all of the strings starting with text, empty if there is none
+	std::string next(text);
+	while (!next.empty() and static_cast<unsigned char>(next.back()) == 0xff)
+		next.pop_back();
+	if (!next.empty())
+		++next.back();
+	Node* first;
+	Node* last = nullptr;
+	if constexpr (DictionaryDetail::isTransparent<Compare>::value) {
+		first = lowerBound(text);
+		if (!next.empty())
+			last = lowerBound(std::string_view(next));
+	}
+	else {
+		first = lowerBound(Key(text));
+		if (!next.empty())
+			last = lowerBound(Key(next));
+	}
+	return range_view(iterator(first, this), iterator(last, this));
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename K, typename ToDo>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::visitRange(Node* curr, const K& lo, const K& hi, ToDo& method) const {
+	while (curr) {
+		bool fromLo = !comp(curr->m_key, lo), toHi = !comp(hi, curr->m_key);
+		//smaller keys can be in range only when this one is not below lo
+		if (fromLo)
+			visitRange(curr->left, lo, hi, method);
+		if (fromLo and toHi)
+			method(const_iterator(curr, this));
+		//the right subtree is a loop, so the recursion is as deep as the left edges of the path
+		if (!toHi)
+			return;
+		curr = curr->right;
+	}
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename ToDo>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::visit_range(const Key& lo, const Key& hi, ToDo method) const {
+	visitRange(head, lo, hi, method);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename K, typename ToDo, typename C, typename>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::visit_range(const K& lo, const K& hi, ToDo method) const {
+	visitRange(head, lo, hi, method);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::iterator Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::select(std::size_t k) const {
+	Node* curr = head;
+	while (curr) {
+		std::size_t left = getSize(curr->left);
+		if (k < left) {
+			curr = curr->left;
+		}
+		else if (k == left) {
+			return iterator(curr, this);
+		}
+		else {
+			//the left subtree and the curr node are before the element we are looking for
+			k -= left + 1;
+			curr = curr->right;
+		}
+	}
+	return end();
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+std::size_t Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::countLess(const Key& key, bool inclusive) const {
+	std::size_t result = 0;
+	Node* curr = head;
+	while (curr) {
+		if (comp(curr->m_key, key) or (inclusive and !comp(key, curr->m_key))) {
+			//curr and its whole left subtree are counted
+			result += getSize(curr->left) + 1;
+			curr = curr->right;
+		}
+		else {
+			curr = curr->left;
+		}
+	}
+	return result;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+std::size_t Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::rank(const Key& key) const {
+	return countLess(key, false);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+std::size_t Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::count_range(const Key& lo, const Key& hi) const {
+	if (comp(hi, lo))
+		return 0;
+	return countLess(hi, true) - countLess(lo, false);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename A>
+typename A::value_type Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::aggregate(const Key& lo, const Key& hi) const {
+	A policy;
+	Node* split = head;
+	//the first node which key is in [lo, hi] on the way down, both paths go through it
+	while (split) {
+		if (comp(split->m_key, lo))
+			split = split->right;
+		else if (comp(hi, split->m_key))
+			split = split->left;
+		else
+			break;
+	}
+	if (!split)
+		return policy.identity();
+	typename A::value_type left = policy.identity(), right = policy.identity();
+	//keys not less than lo in the left subtree, a node in range takes its right subtree as a whole
+	for (Node* curr = split->left; curr;) {
+		if (comp(curr->m_key, lo)) {
+			curr = curr->right;
+		}
+		else {
+			typename A::value_type part = policy.value(curr->m_key, curr->m_info);
+			if (curr->right)
+				part = policy.combine(part, curr->right->aggregate);
+			left = policy.combine(part, left);
+			curr = curr->left;
+		}
+	}
+	//keys not greater than hi in the right subtree, symmetrically
+	for (Node* curr = split->right; curr;) {
+		if (comp(hi, curr->m_key)) {
+			curr = curr->left;
+		}
+		else {
+			typename A::value_type part = policy.value(curr->m_key, curr->m_info);
+			if (curr->left)
+				part = policy.combine(curr->left->aggregate, part);
+			right = policy.combine(right, part);
+			curr = curr->right;
+		}
+	}
+	return policy.combine(policy.combine(left, policy.value(split->m_key, split->m_info)), right);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename A>
+typename A::value_type Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::aggregate() const {
+	return head ? head->aggregate : A().identity();
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Node* Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::attach(Node* curr, Node* left, Node* right) {
+	curr->left = left;
+	curr->right = right;
+	if (left)
+		left->up = curr;
+	if (right)
+		right->up = curr;
+	update(curr);
+	return curr;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Node* Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::joinRight(Node* left, Node* middle, Node* right) {
+	Node* cache = left->right;
+	if (getHeight(cache) <= getHeight(right) + 1) {
+		Node* joined = attach(middle, cache, right);
+		if (joined->height > getHeight(left->left) + 1) {
+			//right-left case
+			rightRotate(joined);
+			attach(left, left->left, joined);
+			leftRotate(left);
+			return left;
+		}
+		return attach(left, left->left, joined);
+	}
+	//we go down along the right spine until the heights are close enough
+	Node* joined = joinRight(cache, middle, right);
+	attach(left, left->left, joined);
+	if (joined->height > getHeight(left->left) + 1)
+		leftRotate(left);
+	return left;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Node* Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::joinLeft(Node* left, Node* middle, Node* right) {
+	Node* cache = right->left;
+	if (getHeight(cache) <= getHeight(left) + 1) {
+		Node* joined = attach(middle, left, cache);
+		if (joined->height > getHeight(right->right) + 1) {
+			//left-right case
+			leftRotate(joined);
+			attach(right, joined, right->right);
+			rightRotate(right);
+			return right;
+		}
+		return attach(right, joined, right->right);
+	}
+	//same as joinRight but along the left spine
+	Node* joined = joinLeft(left, middle, cache);
+	attach(right, joined, right->right);
+	if (joined->height > getHeight(right->right) + 1)
+		rightRotate(right);
+	return right;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Node* Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::join(Node* left, Node* middle, Node* right) {
+	if (getHeight(left) > getHeight(right) + 1)
+		return joinRight(left, middle, right);
+	if (getHeight(right) > getHeight(left) + 1)
+		return joinLeft(left, middle, right);
+	return attach(middle, left, right);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Node* Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::splitLast(Node* curr, Node*& last) {
+	if (!curr->right) {
+		last = curr;
+		return curr->left;
+	}
+	Node* rest = splitLast(curr->right, last);
+	return join(curr->left, curr, rest);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Node* Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::join2(Node* left, Node* right) {
+	if (!left)
+		return right;
+	Node* last = nullptr;
+	Node* rest = splitLast(left, last);
+	return join(rest, last, right);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::split(Node* curr, const Key& key, Node*& left, Node*& found, Node*& right) {
+	if (!curr) {
+		left = nullptr;
+		found = nullptr;
+		right = nullptr;
+		return;
+	}
+	Node* l = curr->left;
+	Node* r = curr->right;
+	int order = DictionaryDetail::compareKeys(comp, key, curr->m_key, 0);
+	if (order < 0) {
+		Node* cache = nullptr;
+		split(l, key, left, found, cache);
+		right = join(cache, curr, r);
+	}
+	else if (order > 0) {
+		Node* cache = nullptr;
+		split(r, key, cache, found, right);
+		left = join(l, curr, cache);
+	}
+	else {
+		left = l;
+		found = curr;
+		right = r;
+	}
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename First, typename Second>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::forkJoin(int forks, First first, Second second) {
+	if (forks > 0) {
+		std::future<void> task = std::async(std::launch::async, first);
+		second();
+		task.get();
+	}
+	else {
+		first();
+		second();
+	}
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+int Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::parallelLevels(std::size_t elements) const {
+	//it is not worth to start a thread for small trees
+	if (!NodeTraits::is_always_equal::value or elements < (std::size_t(1) << 16))
+		return 0;
+	int levels = 0;
+	//every level doubles the number of threads
+	for (unsigned threads = std::thread::hardware_concurrency(); threads > 1; threads /= 2)
+		levels++;
+	return levels;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename Combine>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Node* Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::unionNodes(Node* a, Node* b, Combine& combine, int forks) {
+	if (!b)
+		return a;
+	if (!a)
+		return copy(b);
+	Node *left, *found, *right;
+	split(a, b->m_key, left, found, right);
+	if (found)
+		combine(found->m_info, b->m_info);
+	else
+		found = createNode(b->m_key, b->m_info);
+	//both halves are independent so they can be done at the same time
+	forkJoin(forks,
+		[&]() { left = unionNodes(left, b->left, combine, forks - 1); },
+		[&]() { right = unionNodes(right, b->right, combine, forks - 1); });
+	return join(left, found, right);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename Combine>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Node* Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::intersectNodes(Node* a, Node* b, Combine& combine, int forks) {
+	if (!a)
+		return nullptr;
+	if (!b) {
+		clear(a);
+		return nullptr;
+	}
+	Node *left, *found, *right;
+	split(a, b->m_key, left, found, right);
+	forkJoin(forks,
+		[&]() { left = intersectNodes(left, b->left, combine, forks - 1); },
+		[&]() { right = intersectNodes(right, b->right, combine, forks - 1); });
+	if (!found)
+		return join2(left, right);
+	combine(found->m_info, b->m_info);
+	return join(left, found, right);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Node* Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::differenceNodes(Node* a, Node* b, int forks) {
+	if (!a or !b)
+		return a;
+	Node *left, *found, *right;
+	split(a, b->m_key, left, found, right);
+	if (found)
+		destroyNode(found);
+	forkJoin(forks,
+		[&]() { left = differenceNodes(left, b->left, forks - 1); },
+		[&]() { right = differenceNodes(right, b->right, forks - 1); });
+	return join2(left, right);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename Combine>
+typename Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::Node* Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::mergeNodes(Node* a, Node* b, Combine& combine, int forks) {
+	if (!b)
+		return a;
+	if (!a)
+		return b;
+	Node* bLeft = b->left;
+	Node* bRight = b->right;
+	Node *left, *found, *right;
+	split(a, b->m_key, left, found, right);
+	if (found) {
+		combine(found->m_info, std::move(b->m_info));
+		destroyNode(b);
+	}
+	else {
+		found = b;
+	}
+	forkJoin(forks,
+		[&]() { left = mergeNodes(left, bLeft, combine, forks - 1); },
+		[&]() { right = mergeNodes(right, bRight, combine, forks - 1); });
+	return join(left, found, right);
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename Combine>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::union_with(const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& other, Combine combine) {
+	if (this == &other) {
+		//the tree cannot be split while it is being read
+		Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate> cache(other);
+		union_with(cache, combine);
+		return;
+	}
+	head = unionNodes(head, other.head, combine, parallelLevels(size() + other.size()));
+	if (head)
+		head->up = nullptr;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::union_with(const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& other) {
+	union_with(other, [](Info&, const Info&) {});
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename Combine>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::intersection(const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& other, Combine combine) {
+	if (this == &other) {
+		Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate> cache(other);
+		intersection(cache, combine);
+		return;
+	}
+	head = intersectNodes(head, other.head, combine, parallelLevels(size() + other.size()));
+	if (head)
+		head->up = nullptr;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::intersection(const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& other) {
+	intersection(other, [](Info&, const Info&) {});
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::difference(const Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& other) {
+	if (this == &other) {
+		clear();
+		return;
+	}
+	head = differenceNodes(head, other.head, parallelLevels(size() + other.size()));
+	if (head)
+		head->up = nullptr;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+template<typename Combine>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::merge_with(Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& other, Combine combine) {
+	if (this == &other)
+		return;
+	if (alloc != other.alloc) {
+		//nodes of a different allocator cannot be taken over
+		union_with(other, [&combine](Info& mine, const Info& theirs) { combine(mine, Info(theirs)); });
+		other.clear();
+		return;
+	}
+	Node* cache = other.head;
+	other.head = nullptr;
+	head = mergeNodes(head, cache, combine, parallelLevels(size() + getSize(cache)));
+	if (head)
+		head->up = nullptr;
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::merge_with(Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>& other) {
+	merge_with(other, [](Info&, const Info&) {});
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::save(const std::string& filename) const {
+	//the header is filled in when the length of the elements is known
+	std::string data(SerializerDetail::headerSize, '\0');
+	for (iterator it = begin(); it != end(); ++it) {
+		Serializer<Key>::write(data, it.curr->m_key);
+		Serializer<Info>::write(data, it.curr->m_info);
+	}
+	std::size_t length = data.size() - SerializerDetail::headerSize;
+	std::string header(SerializerDetail::magic, sizeof(SerializerDetail::magic));
+	SerializerDetail::putFixed(header, SerializerDetail::version);
+	SerializerDetail::putFixed(header, size());
+	SerializerDetail::putFixed(header, length);
+	data.replace(0, SerializerDetail::headerSize, header);
+	SerializerDetail::putFixed(data, SerializerDetail::checksum(data.data(), data.size()));
+	std::ofstream file(filename, std::ios::binary);
+	file.write(data.data(), std::streamsize(data.size()));
+	if (!file)
+		throw "Could not write the file!";
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+void Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::load(const std::string& filename) {
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	if (!file)
+		throw "Could not open the file!";
+	std::string data(std::size_t(file.tellg()), '\0');
+	file.seekg(0);
+	file.read(&data[0], std::streamsize(data.size()));
+	if (!file)
+		throw "Could not open the file!";
+	const char* p = data.data();
+	const char* end = p + data.size();
+	if (data.size() < SerializerDetail::headerSize + 8 or std::memcmp(p, SerializerDetail::magic, sizeof(SerializerDetail::magic)) != 0)
+		throw "Not a dictionary snapshot!";
+	p += sizeof(SerializerDetail::magic);
+	if (SerializerDetail::getFixed(p, end) != SerializerDetail::version)
+		throw "Unsupported snapshot version!";
+	std::uint64_t count = SerializerDetail::getFixed(p, end);
+	std::uint64_t length = SerializerDetail::getFixed(p, end);
+	//every element takes at least one byte, so a count above the length is never reserved
+	if (length != data.size() - SerializerDetail::headerSize - 8 or count > length)
+		throw "Snapshot is corrupted!";
+	const char* stop = p + length;
+	const char* sum = stop;
+	if (SerializerDetail::getFixed(sum, end) != SerializerDetail::checksum(data.data(), SerializerDetail::headerSize + std::size_t(length)))
+		throw "Snapshot is corrupted!";
+	typedef SerializerDetail::Reader<Key, Info> Reader;
+	Reader first(p, stop, count);
+	reserve(std::size_t(count));
+	assignSorted(std::move(first), Reader(stop, stop, 0));
+}
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+FrozenDictionary<Key, Info, Compare> Dictionary<Key, Info, Compare, Allocator, Storage, Aggregate>::freeze() const {
+	std::vector<const Node*> nodes;
+	nodes.reserve(size());
+	for (iterator it = begin(); it != end(); ++it)
+		nodes.push_back(it.curr);
+	return FrozenDictionary<Key, Info, Compare>(nodes.size(), comp,
+		[&nodes](std::size_t i)
+		{
+			return std::tie(nodes[i]->m_key, nodes[i]->m_info);
+		});
 }
@@ -0,0 +1,263 @@
+#pragma once
+#include<cstddef>
+#include<functional>
+#include<utility>
+#include<vector>
+#include"Dictionary.h"
+namespace FrequencyDictionaryDetail {
+	/**
+	* Order of the index: by count, the same counts by key. A count alone is equal to all of the entries with that count,
+	* so lower_bound(c) finds the first entry with a count not less than c.
+	*/
+	template<typename Key, typename Count, typename Compare>
+	struct IndexCompare {
+		typedef std::pair<Count, const Key*> Entry;
+		typedef void is_transparent;
+		Compare comp;
+		int compare(const Entry& a, const Entry& b) const {
+			if (a.first < b.first)
+				return -1;
+			if (b.first < a.first)
+				return 1;
+			return DictionaryDetail::compareKeys(comp, *a.second, *b.second, 0);
+		}
+		int compare(const Entry& a, const Count& b) const {
+			return (b < a.first) - (a.first < b);
+		}
+		int compare(const Count& a, const Entry& b) const {
+			return (b.first < a) - (a < b.first);
+		}
+		bool operator()(const Entry& a, const Entry& b) const {
+			return compare(a, b) < 0;
+		}
+		bool operator()(const Entry& a, const Count& b) const {
+			return a.first < b;
+		}
+		bool operator()(const Count& a, const Entry& b) const {
+			return a < b.first;
+		}
+	};
+}
+/**
+* \brief Dictionary of counts with a second tree ordered by (count, key), kept up to date by every change.
+* The index points to the keys stored in the first tree (its nodes do not move), so the keys are not copied.
+* Changing a count moves its entry in the index in O(logN), top(k), bottom(k) and atLeast(c) are O(logN + k) without scanning the whole dictionary.
+* upsert accepts the same methods as Dictionary::upsert, so it can be filled by WordCounter as well.
+*/
+template<typename Key, typename Count = int, typename Compare = std::less<Key>>
+class FrequencyDictionary {
+public:
+	typedef Dictionary<Key, Count, Compare> Counts;
+	typedef FrequencyDictionaryDetail::IndexCompare<Key, Count, Compare> IndexCompare;
+	typedef typename IndexCompare::Entry Entry;
+	typedef Dictionary<Entry, bool, IndexCompare> Index;
+private:
+	Counts counts;
+	Index index;
+	/**
+	* Builds the index from the scratch.
+	*/
+	void rebuild();
+	/**
+	* Outputs up to k elements starting from it, with the ties of the k-th one when exact is false.
+	*/
+	template<typename It>
+	std::vector<std::pair<Key, Count>> collect(It it, It end, std::size_t k, bool exact) const;
+public:
+	FrequencyDictionary() = default;
+	FrequencyDictionary(const FrequencyDictionary& x);
+	FrequencyDictionary(FrequencyDictionary&& x) noexcept = default;
+	FrequencyDictionary& operator=(const FrequencyDictionary& x);
+	FrequencyDictionary& operator=(FrequencyDictionary&& x) noexcept = default;
+	~FrequencyDictionary() = default;
+	/**
+	* Functionality: Applies update(Count&) to the count of key (Count() for a new key) and moves its entry in the index.
+	* param[in] key : Key or (with a transparent Compare) anything comparable with it.
+	* param[in] update : Method changing the count.
+	* Outputs true when the key was inserted.
+	*/
+	template<typename K, typename Update>
+	bool upsert(const K& key, Update update);
+	/**
+	* Adds delta to the count of key, outputs the new count.
+	*/
+	template<typename K>
+	Count increment(const K& key, const Count& delta = Count(1));
+	/**
+	* Removes key, outputs false when there is no such key.
+	*/
+	bool remove(const Key& key);
+	/**
+	* Outputs the count of key, Count() when there is no such key.
+	*/
+	template<typename K>
+	Count count(const K& key) const;
+	/**
+	* Outputs true when the key is in the dictionary.
+	*/
+	template<typename K>
+	bool contains(const K& key) const;
+	/**
+	* Outputs the number of keys.
+	*/
+	std::size_t size() const;
+	/**
+	* Outputs true when there are no keys.
+	*/
+	bool empty() const;
+	/**
+	* Removes all of the keys.
+	*/
+	void clear();
+	/**
+	* Outputs k keys with the biggest counts, the biggest one first. With exact = false also the keys with the same count as the k-th one.
+	* Complexity O(logN + k).
+	*/
+	std::vector<std::pair<Key, Count>> top(std::size_t k, bool exact = true) const;
+	/**
+	* Outputs k keys with the smallest counts, the smallest one first. With exact = false also the keys with the same count as the k-th one.
+	* Complexity O(logN + k).
+	*/
+	std::vector<std::pair<Key, Count>> bottom(std::size_t k, bool exact = true) const;
+	/**
+	* Outputs all of the keys with a count not less than c, the smallest count first. Complexity O(logN + k) for k such keys.
+	*/
+	std::vector<std::pair<Key, Count>> atLeast(const Count& c) const;
+	/**
+	* Outputs the dictionary of the counts (ordered by key).
+	*/
+	const Counts& dictionary() const;
+	/**
+	* Outputs the index ordered by (count, key), getKey() of its iterators is a pair of the count and a pointer to the key.
+	*/
+	const Index& byCount() const;
+};
+
+template<typename Key, typename Count, typename Compare>
+void FrequencyDictionary<Key, Count, Compare>::rebuild() {
+	index.clear();
+	counts.executeForAllNodes([this](typename Counts::const_iterator& it) {
+		index.insert(Entry(it.getInfo(), &it.getKey()), true);
+	});
+}
+
+template<typename Key, typename Count, typename Compare>
+FrequencyDictionary<Key, Count, Compare>::FrequencyDictionary(const FrequencyDictionary& x) : counts(x.counts), index() {
+	rebuild();
+}
+
+template<typename Key, typename Count, typename Compare>
+FrequencyDictionary<Key, Count, Compare>& FrequencyDictionary<Key, Count, Compare>::operator=(const FrequencyDictionary& x) {
+	if (this != &x) {
+		//the index points to the nodes of counts, so it goes first
+		index.clear();
+		counts = x.counts;
+		rebuild();
+	}
+	return *this;
+}
+
+template<typename Key, typename Count, typename Compare>
+template<typename K, typename Update>
+bool FrequencyDictionary<Key, Count, Compare>::upsert(const K& key, Update update) {
+	Count before = Count();
+	auto result = counts.upsert(key, [&before, &update](Count& count) {
+		before = count;
+		update(count);
+	});
+	const Key* stored = &result.first.getKey();
+	if (!result.second)
+		index.remove(Entry(before, stored));
+	index.insert(Entry(result.first.getInfo(), stored), true);
+	return result.second;
+}
+
+template<typename Key, typename Count, typename Compare>
+template<typename K>
+Count FrequencyDictionary<Key, Count, Compare>::increment(const K& key, const Count& delta) {
+	Count after = Count();
+	upsert(key, [&delta, &after](Count& count) {
+		count += delta;
+		after = count;
+	});
+	return after;
+}
+
+template<typename Key, typename Count, typename Compare>
+bool FrequencyDictionary<Key, Count, Compare>::remove(const Key& key) {
+	auto it = counts.find(key);
+	if (it.isNull())
+		return false;
+	index.remove(Entry(it.getInfo(), &it.getKey()));
+	return counts.remove(key);
+}
+
+template<typename Key, typename Count, typename Compare>
+template<typename K>
+Count FrequencyDictionary<Key, Count, Compare>::count(const K& key) const {
+	auto it = counts.find(key);
+	return it.isNull() ? Count() : it.getInfo();
+}
+
+template<typename Key, typename Count, typename Compare>
+template<typename K>
+bool FrequencyDictionary<Key, Count, Compare>::contains(const K& key) const {
+	return counts.contains(key);
+}
+
+template<typename Key, typename Count, typename Compare>
+std::size_t FrequencyDictionary<Key, Count, Compare>::size() const {
+	return counts.size();
+}
+
+template<typename Key, typename Count, typename Compare>
+bool FrequencyDictionary<Key, Count, Compare>::empty() const {
+	return counts.empty();
+}
+
+template<typename Key, typename Count, typename Compare>
+void FrequencyDictionary<Key, Count, Compare>::clear() {
+	index.clear();
+	counts.clear();
+}
+
+template<typename Key, typename Count, typename Compare>
+template<typename It>
+std::vector<std::pair<Key, Count>> FrequencyDictionary<Key, Count, Compare>::collect(It it, It end, std::size_t k, bool exact) const {
+	std::vector<std::pair<Key, Count>> result;
+	for (; it != end; ++it) {
+		const Entry& entry = it.getKey();
+		if (result.size() >= k and (exact or k == 0 or result.back().second < entry.first or entry.first < result.back().second))
+			break;
+		result.emplace_back(*entry.second, entry.first);
+	}
+	return result;
+}
+
+template<typename Key, typename Count, typename Compare>
+std::vector<std::pair<Key, Count>> FrequencyDictionary<Key, Count, Compare>::top(std::size_t k, bool exact) const {
+	return collect(index.rbegin(), index.rend(), k, exact);
+}
+
+template<typename Key, typename Count, typename Compare>
+std::vector<std::pair<Key, Count>> FrequencyDictionary<Key, Count, Compare>::bottom(std::size_t k, bool exact) const {
+	return collect(index.begin(), index.end(), k, exact);
+}
+
+template<typename Key, typename Count, typename Compare>
+std::vector<std::pair<Key, Count>> FrequencyDictionary<Key, Count, Compare>::atLeast(const Count& c) const {
+	std::vector<std::pair<Key, Count>> result;
+	for (auto it = index.lower_bound(c); it != index.end(); ++it)
+		result.emplace_back(*it.getKey().second, it.getKey().first);
+	return result;
+}
+
+template<typename Key, typename Count, typename Compare>
+const typename FrequencyDictionary<Key, Count, Compare>::Counts& FrequencyDictionary<Key, Count, Compare>::dictionary() const {
+	return counts;
+}
+
+template<typename Key, typename Count, typename Compare>
+const typename FrequencyDictionary<Key, Count, Compare>::Index& FrequencyDictionary<Key, Count, Compare>::byCount() const {
+	return index;
+}
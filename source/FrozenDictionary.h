@@ -0,0 +1,371 @@
+#pragma once
+#include<cstddef>
+#include<functional>
+#include<iostream>
+#include<tuple>
+#include<utility>
+#include<vector>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include<xmmintrin.h>
+#endif
+
+template<typename Key, typename Info, typename Compare, typename Allocator, typename Storage, typename Aggregate>
+class Dictionary;
+/**
+* \brief Immutable, read-only version of the Dictionary, obtained with Dictionary::freeze().
+* Keys are stored in a flat array in Eytzinger (BFS) order: the children of the element k (counting from 1)
+* are 2k and 2k+1. The top of the tree is at the beginning of the array and the lookup does not chase any pointers,
+* infos are stored in a separate array and they are touched only when the element was found.
+* Keys are ordered with Compare, same as in the Dictionary.
+*/
+template<typename Key, typename Info, typename Compare = std::less<Key>>
+class FrozenDictionary {
+	template<typename K, typename I, typename C, typename A, typename S, typename G>
+	friend class Dictionary;
+	//keys[k - 1] and infos[k - 1] are the element k of the implicit tree
+	std::vector<Key> keys;
+	std::vector<Info> infos;
+	Compare comp;
+	/**
+	* Builds the arrays from count sorted elements, element(i) outputs the i-th smallest (key, info) pair.
+	*/
+	template<typename Element>
+	FrozenDictionary(std::size_t count, const Compare& c, Element element);
+	/**
+	* Places the sorted elements in Eytzinger order.
+	*/
+	template<typename Element>
+	void build(std::size_t count, Element element);
+	/**
+	* Outputs the element of the implicit tree with the smallest key which is not less than a given key, 0 if there is none.
+	* Approche: Branchless descent, every level is one comparison which is turned into the index of the next child.
+	* The elements four levels below are prefetched, they are 16 consecutive keys so they share one or two cache lines.
+	*/
+	std::size_t search(const Key& key) const;
+	/**
+	* In order successor and predecessor in the implicit tree of count elements, 0 is the end.
+	*/
+	static std::size_t next(std::size_t k, std::size_t count);
+	static std::size_t prev(std::size_t k, std::size_t count);
+public:
+	/**
+	* Iterator of the frozen dictionary. Same as the iterator of Dictionary, but it does not allow to modify the info.
+	*/
+	class iterator {
+		friend FrozenDictionary<Key, Info, Compare>;
+		const FrozenDictionary<Key, Info, Compare>* master;
+		mutable std::size_t curr;
+		iterator(std::size_t x, const FrozenDictionary<Key, Info, Compare>* m);
+	public:
+		iterator();
+		iterator(const iterator& x) = default;
+		~iterator() = default;
+
+		iterator& operator=(const iterator& x) = default;
+
+		bool operator==(const iterator& x) const;
+
+		bool operator!=(const iterator& x) const;
+
+		const iterator& operator++() const;
+
+		iterator operator++(int) const;
+
+		const iterator& operator--() const;
+
+		iterator operator--(int) const;
+
+		const Info& operator*() const;
+
+		const Key& getKey() const;
+
+		const Info& getInfo() const;
+
+		bool isNull() const;
+
+		friend std::ostream& operator<<(std::ostream& out, const iterator& it) {
+			if (it.isNull()) {
+				out << "Key: " << " - " << ", info: " << " - ";
+			}
+			else {
+				out << "Key: " << it.getKey() << ", info: " << it.getInfo();
+			}
+			return out;
+		}
+	};
+	typedef const iterator const_iterator;
+	/**
+	* Constructor creates an empty dictionary.
+	*/
+	FrozenDictionary();
+	/**
+	* Constructor builds the dictionary from a range of (key, info) pairs in O(n).
+	* The range has to be sorted by key and without duplicates, otherwise "Range is not sorted!" is thrown.
+	*/
+	template<typename It>
+	FrozenDictionary(It first, It last, const Compare& c = Compare());
+	/**
+	* An iterator to the smallest element. O(logN).
+	*/
+	iterator begin() const;
+	/**
+	* An iterator to the end.
+	*/
+	iterator end() const;
+	/**
+	* Outputs the number of elements.
+	*/
+	std::size_t size() const;
+	/**
+	* Checks whether the dictionary is empty.
+	*/
+	bool empty() const;
+	/**
+	* The method finds an element with a given key. If an element was not found the empty iterator is being returned.
+	* param[in] key : Key to find a value.
+	*/
+	iterator find(const Key& key) const;
+	/**
+	* Checks whether an element with a given key is a member of the dictionary.
+	*/
+	bool contains(const Key& key) const;
+	/**
+	* Outputs an iterator to the first element which key is not less than a given key.
+	*/
+	iterator lower_bound(const Key& key) const;
+};
+
+template<typename Key, typename Info, typename Compare>
+template<typename Element>
+FrozenDictionary<Key, Info, Compare>::FrozenDictionary(std::size_t count, const Compare& c, Element element) : comp(c) {
+	build(count, element);
+}
+
+template<typename Key, typename Info, typename Compare>
+template<typename Element>
+void FrozenDictionary<Key, Info, Compare>::build(std::size_t count, Element element) {
+	//in order walk over the implicit tree gives the position of every element in the sorted order
+	std::vector<std::size_t> order(count);
+	std::size_t k = 1;
+	for (std::size_t i = 0; i < count; i++) {
+		if (i == 0) {
+			while (2 * k <= count)
+				k = 2 * k;
+		}
+		else {
+			k = next(k, count);
+		}
+		order[k - 1] = i;
+	}
+	keys.reserve(count);
+	infos.reserve(count);
+	for (std::size_t i = 0; i < count; i++) {
+		auto&& e = element(order[i]);
+		keys.push_back(std::get<0>(e));
+		infos.push_back(std::get<1>(e));
+	}
+}
+
+template<typename Key, typename Info, typename Compare>
+std::size_t FrozenDictionary<Key, Info, Compare>::search(const Key& key) const {
+	const Key* base = keys.data();
+	const std::size_t count = keys.size();
+	std::size_t k = 1;
+	while (k <= count) {
+		//four levels below there are 16 consecutive elements starting at 16k
+		std::size_t ahead = 16 * k <= count ? 16 * k : k;
+#if defined(__GNUC__) || defined(__clang__)
+		__builtin_prefetch(base + ahead - 1);
+#elif defined(_MSC_VER)
+		_mm_prefetch(reinterpret_cast<const char*>(base + ahead - 1), _MM_HINT_T0);
+#endif
+		k = 2 * k + comp(base[k - 1], key);
+	}
+	//the last step to the left was made from the result, so the right steps (ones at the end of k) are dropped
+	while (k & 1)
+		k >>= 1;
+	return k >> 1;
+}
+
+template<typename Key, typename Info, typename Compare>
+std::size_t FrozenDictionary<Key, Info, Compare>::next(std::size_t k, std::size_t count) {
+	if (2 * k + 1 <= count) {
+		//the leftmost element of the right subtree
+		k = 2 * k + 1;
+		while (2 * k <= count)
+			k = 2 * k;
+		return k;
+	}
+	//going up as long as we are the right child
+	while (k & 1)
+		k >>= 1;
+	return k >> 1;
+}
+
+template<typename Key, typename Info, typename Compare>
+std::size_t FrozenDictionary<Key, Info, Compare>::prev(std::size_t k, std::size_t count) {
+	if (2 * k <= count) {
+		//the rightmost element of the left subtree
+		k = 2 * k;
+		while (2 * k + 1 <= count)
+			k = 2 * k + 1;
+		return k;
+	}
+	//going up as long as we are the left child
+	while (k > 1 and !(k & 1))
+		k >>= 1;
+	return k >> 1;
+}
+
+template<typename Key, typename Info, typename Compare>
+FrozenDictionary<Key, Info, Compare>::iterator::iterator(std::size_t x, const FrozenDictionary<Key, Info, Compare>* m) : master(m), curr(x) {}
+
+template<typename Key, typename Info, typename Compare>
+FrozenDictionary<Key, Info, Compare>::iterator::iterator() : master(nullptr), curr(0) {}
+
+template<typename Key, typename Info, typename Compare>
+bool FrozenDictionary<Key, Info, Compare>::iterator::operator==(const iterator& x) const {
+	return curr == x.curr and master == x.master;
+}
+
+template<typename Key, typename Info, typename Compare>
+bool FrozenDictionary<Key, Info, Compare>::iterator::operator!=(const iterator& x) const {
+	return curr != x.curr or master != x.master;
+}
+
+template<typename Key, typename Info, typename Compare>
+const typename FrozenDictionary<Key, Info, Compare>::iterator& FrozenDictionary<Key, Info, Compare>::iterator::operator++() const {
+	if (!master) {
+		throw "Master does not exist!";
+	}
+	if (master->empty()) {
+		throw "Master is empty!";
+	}
+	//from the end we are going to the smallest element, same as in Dictionary
+	if (curr == 0)
+		curr = master->begin().curr;
+	else
+		curr = next(curr, master->size());
+	return *this;
+}
+
+template<typename Key, typename Info, typename Compare>
+typename FrozenDictionary<Key, Info, Compare>::iterator FrozenDictionary<Key, Info, Compare>::iterator::operator++(int) const {
+	iterator cache(*this);
+	operator++();
+	return cache;
+}
+
+template<typename Key, typename Info, typename Compare>
+const typename FrozenDictionary<Key, Info, Compare>::iterator& FrozenDictionary<Key, Info, Compare>::iterator::operator--() const {
+	if (!master) {
+		throw "Master does not exist!";
+	}
+	if (master->empty()) {
+		throw "Master is empty!";
+	}
+	//from the end we are going to the biggest element
+	if (curr == 0) {
+		curr = 1;
+		while (2 * curr + 1 <= master->size())
+			curr = 2 * curr + 1;
+	}
+	else {
+		curr = prev(curr, master->size());
+	}
+	return *this;
+}
+
+template<typename Key, typename Info, typename Compare>
+typename FrozenDictionary<Key, Info, Compare>::iterator FrozenDictionary<Key, Info, Compare>::iterator::operator--(int) const {
+	iterator cache(*this);
+	operator--();
+	return cache;
+}
+
+template<typename Key, typename Info, typename Compare>
+const Info& FrozenDictionary<Key, Info, Compare>::iterator::operator*() const {
+	return getInfo();
+}
+
+template<typename Key, typename Info, typename Compare>
+const Key& FrozenDictionary<Key, Info, Compare>::iterator::getKey() const {
+	if (curr == 0)
+		throw "Iterator does not have a value!";
+	return master->keys[curr - 1];
+}
+
+template<typename Key, typename Info, typename Compare>
+const Info& FrozenDictionary<Key, Info, Compare>::iterator::getInfo() const {
+	if (curr == 0)
+		throw "Iterator does not have a value!";
+	return master->infos[curr - 1];
+}
+
+template<typename Key, typename Info, typename Compare>
+bool FrozenDictionary<Key, Info, Compare>::iterator::isNull() const {
+	return curr == 0;
+}
+
+template<typename Key, typename Info, typename Compare>
+FrozenDictionary<Key, Info, Compare>::FrozenDictionary() : comp() {}
+
+template<typename Key, typename Info, typename Compare>
+template<typename It>
+FrozenDictionary<Key, Info, Compare>::FrozenDictionary(It first, It last, const Compare& c) : comp(c) {
+	std::vector<It> elements;
+	for (; first != last; ++first) {
+		if (!elements.empty() and !comp(std::get<0>(*elements.back()), std::get<0>(*first)))
+			throw "Range is not sorted!";
+		elements.push_back(first);
+	}
+	build(elements.size(),
+		[&elements](std::size_t i)->decltype(*elements[i])
+		{
+			return *elements[i];
+		});
+}
+
+template<typename Key, typename Info, typename Compare>
+typename FrozenDictionary<Key, Info, Compare>::iterator FrozenDictionary<Key, Info, Compare>::begin() const {
+	if (keys.empty())
+		return end();
+	std::size_t k = 1;
+	while (2 * k <= keys.size())
+		k = 2 * k;
+	return iterator(k, this);
+}
+
+template<typename Key, typename Info, typename Compare>
+typename FrozenDictionary<Key, Info, Compare>::iterator FrozenDictionary<Key, Info, Compare>::end() const {
+	return iterator(0, this);
+}
+
+template<typename Key, typename Info, typename Compare>
+std::size_t FrozenDictionary<Key, Info, Compare>::size() const {
+	return keys.size();
+}
+
+template<typename Key, typename Info, typename Compare>
+bool FrozenDictionary<Key, Info, Compare>::empty() const {
+	return keys.empty();
+}
+
+template<typename Key, typename Info, typename Compare>
+typename FrozenDictionary<Key, Info, Compare>::iterator FrozenDictionary<Key, Info, Compare>::find(const Key& key) const {
+	std::size_t k = search(key);
+	if (k == 0 or comp(key, keys[k - 1]))
+		return iterator();
+	return iterator(k, this);
+}
+
+template<typename Key, typename Info, typename Compare>
+bool FrozenDictionary<Key, Info, Compare>::contains(const Key& key) const {
+	std::size_t k = search(key);
+	return k != 0 and !comp(key, keys[k - 1]);
+}
+
+template<typename Key, typename Info, typename Compare>
+typename FrozenDictionary<Key, Info, Compare>::iterator FrozenDictionary<Key, Info, Compare>::lower_bound(const Key& key) const {
+	return iterator(search(key), this);
+}
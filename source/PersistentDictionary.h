@@ -0,0 +1,611 @@
+#pragma once
+#include<atomic>
+#include<cstddef>
+#include<functional>
+#include<iostream>
+#include<utility>
+#include<vector>
+#include<algorithm>
+#include"Dictionary.h"
+namespace PersistentDictionaryDetail {
+	/**
+	* Node of a persistent AVL tree. There is no up pointer, because a node may be shared by many versions,
+	* it is freed when the last version (or parent node) which references it is released.
+	*/
+	template<typename Key, typename Info>
+	struct Node {
+		Key m_key;
+		Info m_info;
+		Node* left;
+		Node* right;
+		int height;
+		std::atomic<std::size_t> refs;
+		template<typename K, typename I>
+		Node(K&& key, I&& info) : m_key(std::forward<K>(key)), m_info(std::forward<I>(info)), left(nullptr), right(nullptr), height(1), refs(1) {}
+		/**
+		* Copy of a shared node, the children are shared by both of them.
+		*/
+		Node(const Node& x) : m_key(x.m_key), m_info(x.m_info), left(acquire(x.left)), right(acquire(x.right)), height(x.height), refs(1) {}
+		Node& operator=(const Node& x) = delete;
+		/**
+		* Adds a reference to the node, outputs the node.
+		*/
+		static Node* acquire(Node* curr) {
+			if (curr)
+				curr->refs.fetch_add(1, std::memory_order_relaxed);
+			return curr;
+		}
+		/**
+		* Drops a reference to the node, deletes it (and drops its references to the children) when it was the last one.
+		*/
+		static void release(Node* curr) {
+			std::vector<Node*> stack;
+			while (true) {
+				if (curr and curr->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+					stack.push_back(curr->left);
+					stack.push_back(curr->right);
+					delete curr;
+				}
+				if (stack.empty())
+					return;
+				curr = stack.back();
+				stack.pop_back();
+			}
+		}
+	};
+	/**
+	* \brief Immutable version of a PersistentDictionary.
+	* Copying it only adds a reference to the head, every node is shared. It can be read and destroyed by any thread
+	* while the PersistentDictionary it was taken from keeps changing.
+	*/
+	template<typename Key, typename Info, typename Compare>
+	class Snapshot {
+	protected:
+		typedef PersistentDictionaryDetail::Node<Key, Info> NodeType;
+		NodeType* head;
+		std::size_t count;
+		Compare comp;
+		/**
+		* Finds the node with a given key or outputs nullptr.
+		*/
+		NodeType* search(const Key& key) const;
+	public:
+		/**
+		* Forward iterator. Without up pointers it keeps the nodes which are not visited yet (the current one is the last),
+		* so it takes O(logN) memory. It is valid as long as the version it was taken from.
+		*/
+		class iterator {
+			friend Snapshot<Key, Info, Compare>;
+			std::vector<NodeType*> path;
+			/**
+			* Pushes curr and its left descendants.
+			*/
+			void pushLeft(NodeType* curr);
+		public:
+			iterator() = default;
+
+			bool operator==(const iterator& x) const;
+
+			bool operator!=(const iterator& x) const;
+
+			iterator& operator++();
+
+			iterator operator++(int);
+
+			const Info& operator*() const;
+
+			const Key& getKey() const;
+
+			const Info& getInfo() const;
+
+			bool isNull() const;
+
+			friend std::ostream& operator<<(std::ostream& out, const iterator& it) {
+				if (it.isNull()) {
+					out << "Key: " << " - " << ", info: " << " - ";
+				}
+				else {
+					out << "Key: " << it.getKey() << ", info: " << it.getInfo();
+				}
+				return out;
+			}
+		};
+		Snapshot();
+		explicit Snapshot(const Compare& c);
+		Snapshot(const Snapshot& x);
+		Snapshot(Snapshot&& x) noexcept;
+		Snapshot& operator=(const Snapshot& x);
+		Snapshot& operator=(Snapshot&& x) noexcept;
+		~Snapshot();
+		/**
+		* Outputs an iterator to the smallest element.
+		*/
+		iterator begin() const;
+		/**
+		* Outputs the end iterator (null).
+		*/
+		iterator end() const;
+		/**
+		* Outputs an iterator to the element with a given key or end().
+		*/
+		iterator find(const Key& key) const;
+		/**
+		* Outputs true when the key is in the dictionary.
+		*/
+		bool contains(const Key& key) const;
+		/**
+		* Outputs an iterator to the first element which key is not less than key, or end().
+		*/
+		iterator lower_bound(const Key& key) const;
+		/**
+		* Outputs an iterator to the first element which key is greater than key, or end().
+		*/
+		iterator upper_bound(const Key& key) const;
+		/**
+		* Outputs the number of elements.
+		*/
+		std::size_t size() const;
+		/**
+		* Outputs true when there are no elements.
+		*/
+		bool empty() const;
+	};
+}
+/**
+* \brief Persistent AVL dictionary.
+* Nodes are reference counted and shared by the versions. insert and remove copy only the nodes on the path from the head
+* (and the children which are rotated) when they are shared with a snapshot, nodes used only by this dictionary are changed in place,
+* so without snapshots it works like Dictionary. snapshot() outputs an immutable version in O(1).
+* The dictionary itself is not thread safe (one writer), the snapshots can be used by other threads at the same time.
+*/
+template<typename Key, typename Info, typename Compare = std::less<Key>>
+class PersistentDictionary : public PersistentDictionaryDetail::Snapshot<Key, Info, Compare> {
+	typedef PersistentDictionaryDetail::Snapshot<Key, Info, Compare> Base;
+	typedef typename Base::NodeType Node;
+	/**
+	* Outputs the current height of a node.
+	*/
+	static int getHeight(Node* curr);
+	/**
+	* Makes the node of a link changeable in place: it is copied and relinked when someone else (a snapshot) references it too.
+	* Outputs the node. The link holds a valid reference all the time, so an exception leaves a consistent tree.
+	*/
+	static Node* unshare(Node*& link);
+	/**
+	* Rotations of an unshared node, the child which goes up is unshared as well. The link is set to the new root of the subtree.
+	*/
+	static void leftRotate(Node*& link);
+	static void rightRotate(Node*& link);
+	/**
+	* Updates the height of an unshared node and rotates it if it is unbalanced.
+	*/
+	static void rebalance(Node*& link);
+	/**
+	* Path copying insertion into the subtree of link. make() creates the info of a new element, update(Info&) changes an existing one.
+	*/
+	template<typename Make, typename Update>
+	bool insert(Node*& link, const Key& key, Make& make, Update& update);
+	/**
+	* Path copying removal from the subtree of link, the key has to be in it.
+	*/
+	void remove(Node*& link, const Key& key);
+	/**
+	* Removes the minimal node of the subtree, the reference to it is output through min.
+	*/
+	static void removeMin(Node*& link, Node*& min);
+	/**
+	* Common part of the insertions. Outputs true when a new element was created.
+	*/
+	template<typename Make, typename Update>
+	bool put(const Key& key, Make make, Update update);
+public:
+	/**
+	* Immutable version of the dictionary.
+	*/
+	typedef Base Snapshot;
+	PersistentDictionary() = default;
+	explicit PersistentDictionary(const Compare& c);
+	/**
+	* Copies are O(1), the versions are independent afterwards.
+	*/
+	PersistentDictionary(const PersistentDictionary& x) = default;
+	PersistentDictionary(PersistentDictionary&& x) noexcept = default;
+	PersistentDictionary& operator=(const PersistentDictionary& x) = default;
+	PersistentDictionary& operator=(PersistentDictionary&& x) noexcept = default;
+	~PersistentDictionary() = default;
+	/**
+	* Outputs the current version in O(1). Later changes of the dictionary are not visible in it.
+	*/
+	Snapshot snapshot() const;
+	/**
+	* Inserts an element, outputs false (and does not change anything) when the key is already in the dictionary.
+	*/
+	bool insert(const Key& key, const Info& info);
+	/**
+	* Inserts an element or overwrites the info of an existing one. Outputs true when the element was inserted.
+	*/
+	bool insert_or_assign(const Key& key, const Info& info);
+	/**
+	* Applies update(Info&) to the info of key, a new element with Info() is created first if there is no such key.
+	* Outputs true when the element was inserted.
+	*/
+	template<typename Update>
+	bool upsert(const Key& key, Update update);
+	/**
+	* Removes an element, outputs false when there is no such key.
+	*/
+	bool remove(const Key& key);
+	/**
+	* Removes all of the elements, the snapshots keep theirs.
+	*/
+	void clear();
+};
+
+template<typename Key, typename Info, typename Compare>
+PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::Snapshot() : head(nullptr), count(0), comp() {}
+
+template<typename Key, typename Info, typename Compare>
+PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::Snapshot(const Compare& c) : head(nullptr), count(0), comp(c) {}
+
+template<typename Key, typename Info, typename Compare>
+PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::Snapshot(const Snapshot& x) : head(NodeType::acquire(x.head)), count(x.count), comp(x.comp) {}
+
+template<typename Key, typename Info, typename Compare>
+PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::Snapshot(Snapshot&& x) noexcept : head(x.head), count(x.count), comp(x.comp) {
+	x.head = nullptr;
+	x.count = 0;
+}
+
+template<typename Key, typename Info, typename Compare>
+PersistentDictionaryDetail::Snapshot<Key, Info, Compare>& PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::operator=(const Snapshot& x) {
+	//acquire first, x may share the head
+	NodeType* cache = NodeType::acquire(x.head);
+	NodeType::release(head);
+	head = cache;
+	count = x.count;
+	comp = x.comp;
+	return *this;
+}
+
+template<typename Key, typename Info, typename Compare>
+PersistentDictionaryDetail::Snapshot<Key, Info, Compare>& PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::operator=(Snapshot&& x) noexcept {
+	if (this != &x) {
+		NodeType::release(head);
+		head = x.head;
+		count = x.count;
+		comp = x.comp;
+		x.head = nullptr;
+		x.count = 0;
+	}
+	return *this;
+}
+
+template<typename Key, typename Info, typename Compare>
+PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::~Snapshot() {
+	NodeType::release(head);
+}
+
+template<typename Key, typename Info, typename Compare>
+typename PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::NodeType* PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::search(const Key& key) const {
+	NodeType* curr = head;
+	while (curr) {
+		int order = DictionaryDetail::compareKeys(comp, key, curr->m_key, 0);
+		if (order < 0)
+			curr = curr->left;
+		else if (order > 0)
+			curr = curr->right;
+		else
+			return curr;
+	}
+	return nullptr;
+}
+
+template<typename Key, typename Info, typename Compare>
+void PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::iterator::pushLeft(NodeType* curr) {
+	while (curr) {
+		path.push_back(curr);
+		curr = curr->left;
+	}
+}
+
+template<typename Key, typename Info, typename Compare>
+bool PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::iterator::operator==(const iterator& x) const {
+	if (path.empty() or x.path.empty())
+		return path.empty() == x.path.empty();
+	return path.back() == x.path.back();
+}
+
+template<typename Key, typename Info, typename Compare>
+bool PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::iterator::operator!=(const iterator& x) const {
+	return !(*this == x);
+}
+
+template<typename Key, typename Info, typename Compare>
+typename PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::iterator& PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::iterator::operator++() {
+	if (path.empty())
+		throw "Iterator is null!";
+	NodeType* curr = path.back();
+	path.pop_back();
+	//the next one is the minimum of the right subtree, or the closest ancestor which has not been visited yet
+	pushLeft(curr->right);
+	return *this;
+}
+
+template<typename Key, typename Info, typename Compare>
+typename PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::iterator PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::iterator::operator++(int) {
+	iterator cache = *this;
+	++(*this);
+	return cache;
+}
+
+template<typename Key, typename Info, typename Compare>
+const Info& PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::iterator::operator*() const {
+	return getInfo();
+}
+
+template<typename Key, typename Info, typename Compare>
+const Key& PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::iterator::getKey() const {
+	if (path.empty())
+		throw "Iterator is null!";
+	return path.back()->m_key;
+}
+
+template<typename Key, typename Info, typename Compare>
+const Info& PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::iterator::getInfo() const {
+	if (path.empty())
+		throw "Iterator is null!";
+	return path.back()->m_info;
+}
+
+template<typename Key, typename Info, typename Compare>
+bool PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::iterator::isNull() const {
+	return path.empty();
+}
+
+template<typename Key, typename Info, typename Compare>
+typename PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::iterator PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::begin() const {
+	iterator it;
+	it.pushLeft(head);
+	return it;
+}
+
+template<typename Key, typename Info, typename Compare>
+typename PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::iterator PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::end() const {
+	return iterator();
+}
+
+template<typename Key, typename Info, typename Compare>
+typename PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::iterator PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::find(const Key& key) const {
+	iterator it = lower_bound(key);
+	if (!it.isNull() and comp(key, it.getKey()))
+		return iterator();
+	return it;
+}
+
+template<typename Key, typename Info, typename Compare>
+bool PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::contains(const Key& key) const {
+	return search(key) != nullptr;
+}
+
+template<typename Key, typename Info, typename Compare>
+typename PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::iterator PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::lower_bound(const Key& key) const {
+	iterator it;
+	NodeType* curr = head;
+	//only the nodes where the descent goes left are visited later
+	while (curr) {
+		if (!comp(curr->m_key, key)) {
+			it.path.push_back(curr);
+			curr = curr->left;
+		}
+		else {
+			curr = curr->right;
+		}
+	}
+	return it;
+}
+
+template<typename Key, typename Info, typename Compare>
+typename PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::iterator PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::upper_bound(const Key& key) const {
+	iterator it;
+	NodeType* curr = head;
+	while (curr) {
+		if (comp(key, curr->m_key)) {
+			it.path.push_back(curr);
+			curr = curr->left;
+		}
+		else {
+			curr = curr->right;
+		}
+	}
+	return it;
+}
+
+template<typename Key, typename Info, typename Compare>
+std::size_t PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::size() const {
+	return count;
+}
+
+template<typename Key, typename Info, typename Compare>
+bool PersistentDictionaryDetail::Snapshot<Key, Info, Compare>::empty() const {
+	return count == 0;
+}
+
+template<typename Key, typename Info, typename Compare>
+PersistentDictionary<Key, Info, Compare>::PersistentDictionary(const Compare& c) : Base(c) {}
+
+template<typename Key, typename Info, typename Compare>
+int PersistentDictionary<Key, Info, Compare>::getHeight(Node* curr) {
+	return curr ? curr->height : 0;
+}
+
+template<typename Key, typename Info, typename Compare>
+typename PersistentDictionary<Key, Info, Compare>::Node* PersistentDictionary<Key, Info, Compare>::unshare(Node*& link) {
+	//a node referenced once is reachable only through this dictionary, because every node above it was unshared already
+	Node* curr = link;
+	if (curr->refs.load(std::memory_order_acquire) == 1)
+		return curr;
+	link = new Node(*curr);
+	Node::release(curr);
+	return link;
+}
+
+template<typename Key, typename Info, typename Compare>
+void PersistentDictionary<Key, Info, Compare>::leftRotate(Node*& link) {
+	Node* curr = link;
+	Node* right = unshare(curr->right);
+	//references are only moved between the links, no count changes
+	curr->right = right->left;
+	right->left = curr;
+	link = right;
+	curr->height = std::max(getHeight(curr->left), getHeight(curr->right)) + 1;
+	right->height = std::max(getHeight(right->left), getHeight(right->right)) + 1;
+}
+
+template<typename Key, typename Info, typename Compare>
+void PersistentDictionary<Key, Info, Compare>::rightRotate(Node*& link) {
+	Node* curr = link;
+	Node* left = unshare(curr->left);
+	curr->left = left->right;
+	left->right = curr;
+	link = left;
+	curr->height = std::max(getHeight(curr->left), getHeight(curr->right)) + 1;
+	left->height = std::max(getHeight(left->left), getHeight(left->right)) + 1;
+}
+
+template<typename Key, typename Info, typename Compare>
+void PersistentDictionary<Key, Info, Compare>::rebalance(Node*& link) {
+	Node* curr = link;
+	curr->height = std::max(getHeight(curr->left), getHeight(curr->right)) + 1;
+	int balance = getHeight(curr->left) - getHeight(curr->right);
+	if (balance > 1) {
+		if (getHeight(curr->left->left) < getHeight(curr->left->right)) {
+			unshare(curr->left);
+			leftRotate(curr->left);
+		}
+		rightRotate(link);
+	}
+	else if (balance < -1) {
+		if (getHeight(curr->right->right) < getHeight(curr->right->left)) {
+			unshare(curr->right);
+			rightRotate(curr->right);
+		}
+		leftRotate(link);
+	}
+}
+
+template<typename Key, typename Info, typename Compare>
+template<typename Make, typename Update>
+bool PersistentDictionary<Key, Info, Compare>::insert(Node*& link, const Key& key, Make& make, Update& update) {
+	if (!link) {
+		link = new Node(key, make());
+		++this->count;
+		return true;
+	}
+	int order = DictionaryDetail::compareKeys(this->comp, key, link->m_key, 0);
+	Node* curr = unshare(link);
+	if (order == 0) {
+		update(curr->m_info);
+		return false;
+	}
+	bool inserted = insert(order < 0 ? curr->left : curr->right, key, make, update);
+	rebalance(link);
+	return inserted;
+}
+
+template<typename Key, typename Info, typename Compare>
+void PersistentDictionary<Key, Info, Compare>::removeMin(Node*& link, Node*& min) {
+	Node* curr = link;
+	if (!curr->left) {
+		//the minimum itself is not changed, the reference of the link goes to min
+		min = curr;
+		link = Node::acquire(curr->right);
+		return;
+	}
+	curr = unshare(link);
+	removeMin(curr->left, min);
+	rebalance(link);
+}
+
+template<typename Key, typename Info, typename Compare>
+void PersistentDictionary<Key, Info, Compare>::remove(Node*& link, const Key& key) {
+	Node* curr = link;
+	int order = DictionaryDetail::compareKeys(this->comp, key, curr->m_key, 0);
+	if (order == 0 and (!curr->left or !curr->right)) {
+		link = Node::acquire(curr->left ? curr->left : curr->right);
+		Node::release(curr);
+		--this->count;
+		return;
+	}
+	curr = unshare(link);
+	if (order < 0) {
+		remove(curr->left, key);
+	}
+	else if (order > 0) {
+		remove(curr->right, key);
+	}
+	else {
+		//two children, the minimum of the right subtree takes the place of the element
+		Node* min = curr->right;
+		while (min->left)
+			min = min->left;
+		Key minKey = min->m_key;
+		Info minInfo = min->m_info;
+		removeMin(curr->right, min);
+		Node::release(min);
+		curr->m_key = std::move(minKey);
+		curr->m_info = std::move(minInfo);
+		--this->count;
+	}
+	rebalance(link);
+}
+
+template<typename Key, typename Info, typename Compare>
+template<typename Make, typename Update>
+bool PersistentDictionary<Key, Info, Compare>::put(const Key& key, Make make, Update update) {
+	return insert(this->head, key, make, update);
+}
+
+template<typename Key, typename Info, typename Compare>
+typename PersistentDictionary<Key, Info, Compare>::Snapshot PersistentDictionary<Key, Info, Compare>::snapshot() const {
+	return Snapshot(*this);
+}
+
+template<typename Key, typename Info, typename Compare>
+bool PersistentDictionary<Key, Info, Compare>::insert(const Key& key, const Info& info) {
+	//an existing key would copy the path for nothing
+	if (this->search(key))
+		return false;
+	return put(key, [&info]() { return info; }, [](Info&) {});
+}
+
+template<typename Key, typename Info, typename Compare>
+bool PersistentDictionary<Key, Info, Compare>::insert_or_assign(const Key& key, const Info& info) {
+	return put(key, [&info]() { return info; }, [&info](Info& existing) { existing = info; });
+}
+
+template<typename Key, typename Info, typename Compare>
+template<typename Update>
+bool PersistentDictionary<Key, Info, Compare>::upsert(const Key& key, Update update) {
+	return put(key,
+		[&update]() {
+			Info info = Info();
+			update(info);
+			return info;
+		},
+		update);
+}
+
+template<typename Key, typename Info, typename Compare>
+bool PersistentDictionary<Key, Info, Compare>::remove(const Key& key) {
+	if (!this->search(key))
+		return false;
+	remove(this->head, key);
+	return true;
+}
+
+template<typename Key, typename Info, typename Compare>
+void PersistentDictionary<Key, Info, Compare>::clear() {
+	Node::release(this->head);
+	this->head = nullptr;
+	this->count = 0;
+}
@@ -0,0 +1,206 @@
+#pragma once
+#include<cstddef>
+#include<cstdint>
+#include<memory>
+#include<new>
+#include<type_traits>
+#include<vector>
+namespace PoolAllocatorDetail {
+	/**
+	* The pool of PoolAllocator. It serves blocks of a single size which is set by the first allocation,
+	* any other request is passed to the global operator new.
+	*/
+	struct Pool {
+		std::size_t blockSize;
+		std::size_t nextChunk;
+		//list of the freed blocks, the pointer to the next free block is stored in the block itself
+		void* freeList;
+		std::size_t freeCount;
+		//the not yet used part of the last chunk
+		char* current;
+		std::size_t left;
+		std::vector<void*> chunks;
+
+		Pool() : blockSize(0), nextChunk(64), freeList(nullptr), freeCount(0), current(nullptr), left(0) {}
+		Pool(const Pool& x) = delete;
+		Pool& operator=(const Pool& x) = delete;
+		~Pool() {
+			release();
+		}
+		/**
+		* Allocates a new chunk of count blocks. The rest of the previous chunk goes to the free list.
+		* Throws std::bad_alloc when the size of the chunk does not fit in std::size_t.
+		*/
+		void grow(std::size_t count) {
+			if (count > SIZE_MAX / blockSize)
+				throw std::bad_alloc();
+			while (left) {
+				push(current);
+				current += blockSize;
+				--left;
+			}
+			current = static_cast<char*>(::operator new(count * blockSize));
+			chunks.push_back(current);
+			left = count;
+		}
+		void push(void* block) {
+			*static_cast<void**>(block) = freeList;
+			freeList = block;
+			++freeCount;
+		}
+		void* pop() {
+			if (freeList) {
+				void* block = freeList;
+				freeList = *static_cast<void**>(block);
+				--freeCount;
+				return block;
+			}
+			if (!left) {
+				grow(nextChunk);
+				//chunks are growing geometrically, so there are O(logN) of them
+				if (nextChunk < (std::size_t(1) << 16))
+					nextChunk *= 2;
+			}
+			void* block = current;
+			current += blockSize;
+			--left;
+			return block;
+		}
+		void reserve(std::size_t count) {
+			if (left + freeCount < count)
+				grow(count - freeCount);
+		}
+		void release() {
+			for (void* chunk : chunks)
+				::operator delete(chunk);
+			chunks.clear();
+			freeList = nullptr;
+			freeCount = 0;
+			current = nullptr;
+			left = 0;
+		}
+	};
+}
+/**
+* \brief Slab/arena allocator for the nodes of the Dictionary.
+* Nodes are cut out of contiguous chunks, freed nodes are kept on a free list and reused.
+* Chunks are given back only when the last copy of the allocator is destroyed or release() is called.
+* Copies (and rebound copies) of the allocator share the same pool, so nodes can travel between them.
+* A moved from allocator does not share the pool, it gets a new one the next time it is used.
+* Usage:
+* Dictionary<int, int, std::less<int>, PoolAllocator<std::pair<const int, int>>> x;
+*/
+template<typename T>
+class PoolAllocator {
+	template<typename U>
+	friend class PoolAllocator;
+	typedef PoolAllocatorDetail::Pool Pool;
+	//empty only after a move, it is created again when needed
+	mutable std::shared_ptr<Pool> pool;
+	/**
+	* Outputs the pool, a moved from allocator gets a new empty one.
+	*/
+	const std::shared_ptr<Pool>& shared() const {
+		if (!pool)
+			pool = std::make_shared<Pool>();
+		return pool;
+	}
+	/**
+	* Size of a single block used for T. It has to be able to hold (and be aligned for) the free list pointer.
+	*/
+	static constexpr std::size_t blockSize() {
+		constexpr std::size_t align = alignof(T) > alignof(void*) ? alignof(T) : alignof(void*);
+		constexpr std::size_t size = sizeof(T) > sizeof(void*) ? sizeof(T) : sizeof(void*);
+		return (size + align - 1) / align * align;
+	}
+	/**
+	* Checks whether the request can be served by the pool. The pool size is set by the first request.
+	*/
+	bool pooled(std::size_t n) const {
+		if (n != 1 or alignof(T) > alignof(std::max_align_t))
+			return false;
+		Pool& p = *shared();
+		if (!p.blockSize)
+			p.blockSize = blockSize();
+		return p.blockSize == blockSize();
+	}
+public:
+	typedef T value_type;
+	typedef std::true_type propagate_on_container_move_assignment;
+	typedef std::false_type is_always_equal;
+	/**
+	* Creates a new empty pool.
+	*/
+	PoolAllocator() : pool(std::make_shared<Pool>()) {}
+	/**
+	* Copies share the pool.
+	*/
+	PoolAllocator(const PoolAllocator& x) : pool(x.shared()) {}
+	/**
+	* Rebound copies share the pool as well.
+	*/
+	template<typename U>
+	PoolAllocator(const PoolAllocator<U>& x) : pool(x.shared()) {}
+	/**
+	* The pool is taken over, x is left with a new pool, so the two allocators can be used independently (also from different threads).
+	*/
+	PoolAllocator(PoolAllocator&& x) noexcept : pool(std::move(x.pool)) {}
+
+	PoolAllocator& operator=(const PoolAllocator& x) {
+		pool = x.shared();
+		return *this;
+	}
+
+	PoolAllocator& operator=(PoolAllocator&& x) noexcept {
+		if (this != &x)
+			pool = std::move(x.pool);
+		return *this;
+	}
+
+	T* allocate(std::size_t n) {
+		if (pooled(n))
+			return static_cast<T*>(pool->pop());
+		return static_cast<T*>(::operator new(n * sizeof(T)));
+	}
+
+	void deallocate(T* p, std::size_t n) {
+		if (pooled(n))
+			pool->push(p);
+		else
+			::operator delete(p);
+	}
+	/**
+	* Makes sure that next count single element allocations do not need a new chunk.
+	*/
+	void reserve(std::size_t count) {
+		if (pooled(1))
+			pool->reserve(count);
+	}
+	/**
+	* Gives back all of the chunks at once in O(chunks). Nothing is destroyed.
+	* It is done only if no other allocator shares the pool, because otherwise someone else may still use the blocks.
+	* Outputs true if the memory was released.
+	*/
+	bool release() {
+		if (pool.use_count() != 1)
+			return false;
+		pool->release();
+		return true;
+	}
+	/**
+	* A copy of the container gets its own pool.
+	*/
+	PoolAllocator select_on_container_copy_construction() const {
+		return PoolAllocator();
+	}
+
+	template<typename U>
+	bool operator==(const PoolAllocator<U>& x) const {
+		return shared() == x.shared();
+	}
+
+	template<typename U>
+	bool operator!=(const PoolAllocator<U>& x) const {
+		return shared() != x.shared();
+	}
+};
@@ -0,0 +1,217 @@
+#pragma once
+#include<cstddef>
+#include<cstdint>
+#include<cstring>
+#include<string>
+#include<type_traits>
+#include<utility>
+
+/**
+* \brief Binary format of one type in a Dictionary snapshot (Dictionary::save and Dictionary::load).
+* A serializer has static void write(std::string& out, const T& x), which appends x to out, and static T read(const char*& p, const char* end),
+* which decodes x starting from p and moves p behind it, throwing "Snapshot is corrupted!" when there are not enough bytes.
+* Integers are varints (the signed ones zigzag encoded), floating point numbers are copied byte by byte (little endian),
+* strings are their length as a varint followed by the characters. Other Key and Info types need a specialization, e.g.
+* template<> struct Serializer<Point> { static void write(std::string& out, const Point& x) {...} static Point read(const char*& p, const char* end) {...} };
+*/
+template<typename T, typename = void>
+struct Serializer;
+
+namespace SerializerDetail {
+	/**
+	* Appends x in 7 bit groups, the lowest first, the highest bit of a byte tells that another one follows.
+	*/
+	inline void putVarint(std::string& out, std::uint64_t x) {
+		char buffer[10];
+		std::size_t length = 0;
+		while (x >= 0x80) {
+			buffer[length++] = char(x | 0x80);
+			x >>= 7;
+		}
+		buffer[length++] = char(x);
+		out.append(buffer, length);
+	}
+	/**
+	* Decodes a varint written by putVarint.
+	*/
+	inline std::uint64_t getVarint(const char*& p, const char* end) {
+		std::uint64_t x = 0;
+		for (unsigned shift = 0; shift < 64 and p != end; shift += 7) {
+			std::uint64_t byte = static_cast<unsigned char>(*p++);
+			x |= (byte & 0x7f) << shift;
+			if (!(byte & 0x80))
+				return x;
+		}
+		throw "Snapshot is corrupted!";
+	}
+	/**
+	* Appends x as 8 bytes, the lowest first, so the file does not depend on the endianness of the machine.
+	*/
+	inline void putFixed(std::string& out, std::uint64_t x) {
+		char buffer[8];
+		for (int i = 0; i < 8; ++i)
+			buffer[i] = char(x >> 8 * i);
+		out.append(buffer, 8);
+	}
+	inline std::uint64_t getFixed(const char*& p, const char* end) {
+		if (end - p < 8)
+			throw "Snapshot is corrupted!";
+		std::uint64_t x = 0;
+		for (int i = 0; i < 8; ++i)
+			x |= std::uint64_t(static_cast<unsigned char>(p[i])) << 8 * i;
+		p += 8;
+		return x;
+	}
+	inline std::uint64_t rotate(std::uint64_t x, int bits) {
+		return x << bits | x >> (64 - bits);
+	}
+	/**
+	* Outputs 8 bytes as a little endian number, one load on little endian machines.
+	*/
+	inline std::uint64_t load64(const char* p) {
+		std::uint64_t x;
+		std::memcpy(&x, p, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		x = __builtin_bswap64(x);
+#endif
+		return x;
+	}
+	/**
+	* Outputs a 64 bit checksum of the bytes. 32 bytes are mixed into four independent lanes per step,
+	* so the multiplications of the lanes overlap and the checksum does not slow down the loading.
+	*/
+	inline std::uint64_t checksum(const char* p, std::size_t size) {
+		const std::uint64_t prime1 = 0x9e3779b185ebca87ull, prime2 = 0xc2b2ae3d27d4eb4full;
+		std::uint64_t lanes[4] = { prime1 + prime2, prime2, 0, 0 - prime1 };
+		const char* end = p + size;
+		for (; end - p >= 32; p += 32)
+			for (int i = 0; i < 4; ++i)
+				lanes[i] = rotate(lanes[i] + load64(p + 8 * i) * prime2, 31) * prime1;
+		std::uint64_t h = rotate(lanes[0], 1) + rotate(lanes[1], 7) + rotate(lanes[2], 12) + rotate(lanes[3], 18) + size;
+		for (; end - p >= 8; p += 8)
+			h = rotate(h ^ rotate(load64(p) * prime2, 31) * prime1, 27) * prime1;
+		for (; p != end; ++p)
+			h = rotate(h ^ static_cast<unsigned char>(*p) * prime1, 11) * prime2;
+		h ^= h >> 33;
+		h *= prime2;
+		h ^= h >> 29;
+		return h;
+	}
+}
+
+template<typename T>
+struct Serializer<T, typename std::enable_if<std::is_integral<T>::value>::type> {
+	static void write(std::string& out, const T& x) {
+		if constexpr (std::is_signed<T>::value) {
+			//zigzag: small negative numbers get short codes as well
+			std::uint64_t value = std::uint64_t(std::int64_t(x));
+			SerializerDetail::putVarint(out, value << 1 ^ (0 - (value >> 63)));
+		}
+		else {
+			SerializerDetail::putVarint(out, std::uint64_t(x));
+		}
+	}
+	static T read(const char*& p, const char* end) {
+		std::uint64_t value = SerializerDetail::getVarint(p, end);
+		if constexpr (std::is_signed<T>::value)
+			return T(std::int64_t(value >> 1 ^ (0 - (value & 1))));
+		else
+			return T(value);
+	}
+};
+
+template<typename T>
+struct Serializer<T, typename std::enable_if<std::is_floating_point<T>::value and (sizeof(T) == 4 or sizeof(T) == 8)>::type> {
+	typedef typename std::conditional<sizeof(T) == 4, std::uint32_t, std::uint64_t>::type Bits;
+	static void write(std::string& out, const T& x) {
+		Bits bits;
+		std::memcpy(&bits, &x, sizeof(T));
+		for (std::size_t i = 0; i < sizeof(T); ++i)
+			out.push_back(char(bits >> 8 * i));
+	}
+	static T read(const char*& p, const char* end) {
+		if (std::size_t(end - p) < sizeof(T))
+			throw "Snapshot is corrupted!";
+		Bits bits = 0;
+		for (std::size_t i = 0; i < sizeof(T); ++i)
+			bits |= Bits(static_cast<unsigned char>(p[i])) << 8 * i;
+		p += sizeof(T);
+		T x;
+		std::memcpy(&x, &bits, sizeof(T));
+		return x;
+	}
+};
+
+template<typename Traits, typename Alloc>
+struct Serializer<std::basic_string<char, Traits, Alloc>> {
+	static void write(std::string& out, const std::basic_string<char, Traits, Alloc>& x) {
+		SerializerDetail::putVarint(out, x.size());
+		out.append(x.data(), x.size());
+	}
+	static std::basic_string<char, Traits, Alloc> read(const char*& p, const char* end) {
+		std::uint64_t length = SerializerDetail::getVarint(p, end);
+		if (std::uint64_t(end - p) < length)
+			throw "Snapshot is corrupted!";
+		std::basic_string<char, Traits, Alloc> x(p, std::size_t(length));
+		p += length;
+		return x;
+	}
+};
+
+template<typename A, typename B>
+struct Serializer<std::pair<A, B>> {
+	static void write(std::string& out, const std::pair<A, B>& x) {
+		Serializer<A>::write(out, x.first);
+		Serializer<B>::write(out, x.second);
+	}
+	static std::pair<A, B> read(const char*& p, const char* end) {
+		A first = Serializer<A>::read(p, end);
+		return std::pair<A, B>(std::move(first), Serializer<B>::read(p, end));
+	}
+};
+
+namespace SerializerDetail {
+	/**
+	* Header of a snapshot: magic, version, number of elements and length of the elements in bytes (all 8 byte little endian numbers).
+	* The elements (key, info, key, info, ... in sorted order) are followed by the checksum of the header and the elements.
+	*/
+	const char magic[8] = { 'E', 'A', 'D', 'S', 'D', 'I', 'C', 'T' };
+	const std::uint64_t version = 2;
+	const std::size_t headerSize = 32;
+	/**
+	* Single pass input iterator decoding the (key, info) pairs of a snapshot. The current pair is decoded by the constructor and by ++,
+	* * outputs it as an rvalue, so the bulk build moves the keys and the infos into the nodes. The end is Reader(end, end, 0).
+	*/
+	template<typename Key, typename Info>
+	class Reader {
+		const char* p;
+		const char* end;
+		std::uint64_t left;
+		std::pair<Key, Info> current;
+		void next() {
+			if (!left) {
+				//the count and the length of the elements have to agree
+				if (p != end)
+					throw "Snapshot is corrupted!";
+				return;
+			}
+			current.first = Serializer<Key>::read(p, end);
+			current.second = Serializer<Info>::read(p, end);
+		}
+	public:
+		Reader(const char* p, const char* end, std::uint64_t count) : p(p), end(end), left(count), current() {
+			next();
+		}
+		std::pair<Key, Info>&& operator*() {
+			return std::move(current);
+		}
+		Reader& operator++() {
+			--left;
+			next();
+			return *this;
+		}
+		bool operator!=(const Reader& x) const {
+			return left != x.left;
+		}
+	};
+}
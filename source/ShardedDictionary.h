@@ -0,0 +1,359 @@
+#pragma once
+#include<cstddef>
+#include<functional>
+#include<mutex>
+#include<string>
+#include<string_view>
+#include<thread>
+#include<utility>
+#include<vector>
+#include<algorithm>
+#include"Dictionary.h"
+namespace ShardedDictionaryDetail {
+	/**
+	* Hash used to choose the shard, std::hash by default.
+	*/
+	template<typename Key>
+	struct Hash {
+		std::size_t operator()(const Key& key) const {
+			return std::hash<Key>()(key);
+		}
+	};
+	/**
+	* Strings are hashed as string views, so a std::string_view (or a literal) goes to the same shard as the std::string key.
+	*/
+	template<typename Char, typename Traits, typename Alloc>
+	struct Hash<std::basic_string<Char, Traits, Alloc>> {
+		template<typename K>
+		std::size_t operator()(const K& key) const {
+			return std::hash<std::basic_string_view<Char, Traits>>()(std::basic_string_view<Char, Traits>(key));
+		}
+	};
+}
+/**
+* \brief Dictionary partitioned into shards by the hash of the key.
+* Every shard is a separate Dictionary with its own mutex, so threads which count different keys rarely wait for each other.
+* A shard can be also used directly (shard(i), without locking) by a thread which owns it.
+* Iteration goes through all of the elements in order (a k-way merge of the shards), it must not run at the same time as the writers.
+*/
+template<typename Key, typename Info, typename Compare = std::less<Key>, typename Hash = ShardedDictionaryDetail::Hash<Key>>
+class ShardedDictionary {
+public:
+	typedef Dictionary<Key, Info, Compare> Shard;
+private:
+	//separate cache lines, so the locks of the neighbouring shards do not share one
+	struct alignas(64) Part {
+		mutable std::mutex mutex;
+		Shard tree;
+	};
+	std::vector<Part> parts;
+	Compare comp;
+	Hash hash;
+public:
+	/**
+	* Ordered iterator. It keeps a heap of the current iterators of all shards, so ++ is O(log(shards) + logN).
+	*/
+	class iterator {
+		friend ShardedDictionary<Key, Info, Compare, Hash>;
+		const ShardedDictionary<Key, Info, Compare, Hash>* master;
+		std::vector<typename Shard::iterator> heap;
+		iterator(const ShardedDictionary<Key, Info, Compare, Hash>* m);
+		/**
+		* Order of the heap, the smallest key is on the top.
+		*/
+		bool greater(const typename Shard::iterator& a, const typename Shard::iterator& b) const;
+	public:
+		iterator();
+
+		bool operator==(const iterator& x) const;
+
+		bool operator!=(const iterator& x) const;
+
+		iterator& operator++();
+
+		iterator operator++(int);
+
+		const Info& operator*() const;
+
+		const Key& getKey() const;
+
+		const Info& getInfo() const;
+
+		bool isNull() const;
+
+		friend std::ostream& operator<<(std::ostream& out, const iterator& it) {
+			if (it.isNull()) {
+				out << "Key: " << " - " << ", info: " << " - ";
+			}
+			else {
+				out << "Key: " << it.getKey() << ", info: " << it.getInfo();
+			}
+			return out;
+		}
+	};
+	/**
+	* Creates count shards (at least one), one per hardware thread by default.
+	*/
+	explicit ShardedDictionary(std::size_t count = std::thread::hardware_concurrency());
+	ShardedDictionary(const ShardedDictionary& x) = delete;
+	ShardedDictionary& operator=(const ShardedDictionary& x) = delete;
+	~ShardedDictionary() = default;
+	/**
+	* Outputs the index of the shard of key. K is Key or (with a transparent Compare) anything Hash accepts, e.g. std::string_view.
+	*/
+	template<typename K>
+	std::size_t shardOf(const K& key) const;
+	/**
+	* Outputs the number of shards.
+	*/
+	std::size_t shards() const;
+	/**
+	* Outputs a shard, it is not locked.
+	*/
+	Shard& shard(std::size_t i);
+	const Shard& shard(std::size_t i) const;
+	/**
+	* Adds delta to the info of key, a new element with Info() is created first if there is no such key.
+	*/
+	template<typename K>
+	void increment(const K& key, const Info& delta);
+	/**
+	* Applies update(Info&) to the info of key under the lock of its shard, see Dictionary::upsert.
+	* Outputs true when the element was inserted.
+	*/
+	template<typename K, typename Update>
+	bool upsert(const K& key, Update update);
+	/**
+	* Inserts an element, outputs false when the key is already in the dictionary.
+	*/
+	bool insert(const Key& key, const Info& info);
+	/**
+	* Removes an element, outputs false when there is no such key.
+	*/
+	bool remove(const Key& key);
+	/**
+	* Copies the info of key to info, outputs false when there is no such key.
+	*/
+	template<typename K>
+	bool find(const K& key, Info& info) const;
+	/**
+	* Outputs true when the key is in the dictionary.
+	*/
+	template<typename K>
+	bool contains(const K& key) const;
+	/**
+	* Outputs the number of elements (the sum of the shards).
+	*/
+	std::size_t size() const;
+	/**
+	* Outputs true when there are no elements.
+	*/
+	bool empty() const;
+	/**
+	* Removes all of the elements.
+	*/
+	void clear();
+	/**
+	* Outputs an iterator to the smallest element of all shards.
+	*/
+	iterator begin() const;
+	/**
+	* Outputs the end iterator (null).
+	*/
+	iterator end() const;
+	/**
+	* Copies the elements to one Dictionary in O(n), they are already sorted by the merge.
+	*/
+	Dictionary<Key, Info, Compare> toDictionary() const;
+};
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+ShardedDictionary<Key, Info, Compare, Hash>::iterator::iterator() : master(nullptr) {}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+ShardedDictionary<Key, Info, Compare, Hash>::iterator::iterator(const ShardedDictionary<Key, Info, Compare, Hash>* m) : master(m) {
+	for (const Part& part : m->parts) {
+		if (!part.tree.empty())
+			heap.push_back(part.tree.begin());
+	}
+	std::make_heap(heap.begin(), heap.end(), [this](const typename Shard::iterator& a, const typename Shard::iterator& b) { return greater(a, b); });
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+bool ShardedDictionary<Key, Info, Compare, Hash>::iterator::greater(const typename Shard::iterator& a, const typename Shard::iterator& b) const {
+	return master->comp(b.getKey(), a.getKey());
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+bool ShardedDictionary<Key, Info, Compare, Hash>::iterator::operator==(const iterator& x) const {
+	if (heap.empty() or x.heap.empty())
+		return heap.empty() == x.heap.empty();
+	return heap.front() == x.heap.front();
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+bool ShardedDictionary<Key, Info, Compare, Hash>::iterator::operator!=(const iterator& x) const {
+	return !(*this == x);
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+typename ShardedDictionary<Key, Info, Compare, Hash>::iterator& ShardedDictionary<Key, Info, Compare, Hash>::iterator::operator++() {
+	if (heap.empty())
+		throw "Iterator is null!";
+	auto order = [this](const typename Shard::iterator& a, const typename Shard::iterator& b) { return greater(a, b); };
+	//the smallest goes to the back, it is moved on and put back to the heap unless its shard has ended
+	std::pop_heap(heap.begin(), heap.end(), order);
+	++heap.back();
+	if (heap.back().isNull())
+		heap.pop_back();
+	else
+		std::push_heap(heap.begin(), heap.end(), order);
+	return *this;
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+typename ShardedDictionary<Key, Info, Compare, Hash>::iterator ShardedDictionary<Key, Info, Compare, Hash>::iterator::operator++(int) {
+	iterator cache = *this;
+	++(*this);
+	return cache;
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+const Info& ShardedDictionary<Key, Info, Compare, Hash>::iterator::operator*() const {
+	return getInfo();
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+const Key& ShardedDictionary<Key, Info, Compare, Hash>::iterator::getKey() const {
+	if (heap.empty())
+		throw "Iterator is null!";
+	return heap.front().getKey();
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+const Info& ShardedDictionary<Key, Info, Compare, Hash>::iterator::getInfo() const {
+	if (heap.empty())
+		throw "Iterator is null!";
+	return heap.front().getInfo();
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+bool ShardedDictionary<Key, Info, Compare, Hash>::iterator::isNull() const {
+	return heap.empty();
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+ShardedDictionary<Key, Info, Compare, Hash>::ShardedDictionary(std::size_t count) : parts(std::max<std::size_t>(count, 1)), comp(), hash() {}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+template<typename K>
+std::size_t ShardedDictionary<Key, Info, Compare, Hash>::shardOf(const K& key) const {
+	//std::hash of integers is the identity, the bits are mixed before taking the remainder
+	std::size_t mixed = std::size_t(hash(key) * 0x9E3779B97F4A7C15ull);
+	return (mixed >> 32 ^ mixed) % parts.size();
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+std::size_t ShardedDictionary<Key, Info, Compare, Hash>::shards() const {
+	return parts.size();
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+typename ShardedDictionary<Key, Info, Compare, Hash>::Shard& ShardedDictionary<Key, Info, Compare, Hash>::shard(std::size_t i) {
+	return parts[i].tree;
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+const typename ShardedDictionary<Key, Info, Compare, Hash>::Shard& ShardedDictionary<Key, Info, Compare, Hash>::shard(std::size_t i) const {
+	return parts[i].tree;
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+template<typename K>
+void ShardedDictionary<Key, Info, Compare, Hash>::increment(const K& key, const Info& delta) {
+	upsert(key, [&delta](Info& info) { info += delta; });
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+template<typename K, typename Update>
+bool ShardedDictionary<Key, Info, Compare, Hash>::upsert(const K& key, Update update) {
+	Part& part = parts[shardOf(key)];
+	std::lock_guard<std::mutex> lock(part.mutex);
+	return part.tree.upsert(key, update).second;
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+bool ShardedDictionary<Key, Info, Compare, Hash>::insert(const Key& key, const Info& info) {
+	Part& part = parts[shardOf(key)];
+	std::lock_guard<std::mutex> lock(part.mutex);
+	return part.tree.insert(key, info);
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+bool ShardedDictionary<Key, Info, Compare, Hash>::remove(const Key& key) {
+	Part& part = parts[shardOf(key)];
+	std::lock_guard<std::mutex> lock(part.mutex);
+	return part.tree.remove(key);
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+template<typename K>
+bool ShardedDictionary<Key, Info, Compare, Hash>::find(const K& key, Info& info) const {
+	const Part& part = parts[shardOf(key)];
+	std::lock_guard<std::mutex> lock(part.mutex);
+	auto it = part.tree.find(key);
+	if (it.isNull())
+		return false;
+	info = it.getInfo();
+	return true;
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+template<typename K>
+bool ShardedDictionary<Key, Info, Compare, Hash>::contains(const K& key) const {
+	const Part& part = parts[shardOf(key)];
+	std::lock_guard<std::mutex> lock(part.mutex);
+	return part.tree.contains(key);
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+std::size_t ShardedDictionary<Key, Info, Compare, Hash>::size() const {
+	std::size_t count = 0;
+	for (const Part& part : parts) {
+		std::lock_guard<std::mutex> lock(part.mutex);
+		count += part.tree.size();
+	}
+	return count;
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+bool ShardedDictionary<Key, Info, Compare, Hash>::empty() const {
+	return size() == 0;
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+void ShardedDictionary<Key, Info, Compare, Hash>::clear() {
+	for (Part& part : parts) {
+		std::lock_guard<std::mutex> lock(part.mutex);
+		part.tree.clear();
+	}
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+typename ShardedDictionary<Key, Info, Compare, Hash>::iterator ShardedDictionary<Key, Info, Compare, Hash>::begin() const {
+	return iterator(this);
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+typename ShardedDictionary<Key, Info, Compare, Hash>::iterator ShardedDictionary<Key, Info, Compare, Hash>::end() const {
+	return iterator();
+}
+
+template<typename Key, typename Info, typename Compare, typename Hash>
+Dictionary<Key, Info, Compare> ShardedDictionary<Key, Info, Compare, Hash>::toDictionary() const {
+	std::vector<std::pair<Key, Info>> sorted;
+	sorted.reserve(size());
+	for (iterator it = begin(); !it.isNull(); ++it)
+		sorted.emplace_back(it.getKey(), it.getInfo());
+	return Dictionary<Key, Info, Compare>(sorted.begin(), sorted.end());
+}
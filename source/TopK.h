@@ -0,0 +1,137 @@
+#pragma once
+#include<cstddef>
+#include<algorithm>
+#include<functional>
+#include<thread>
+#include<utility>
+#include<vector>
+
+/**
+* \brief The k best of the pushed elements, better(a, b) is true when a should be before b (e.g. a bigger frequency).
+* The kept elements are a bounded binary heap with the worst of them on the top, so push is O(log k) and n elements take O(n log k).
+* When exact is false the elements equal to the k-th one (ties) are kept as well, still in a single pass:
+* an element equal to the top goes to the ties instead of being dropped and the ties are forgotten when the top gets better.
+*/
+template<typename T, typename Compare = std::less<T>>
+class TopK {
+	std::vector<T> heap;
+	//elements equal to the top of the heap which did not fit in it
+	std::vector<T> ties;
+	std::size_t k;
+	bool exact;
+	Compare better;
+	bool equal(const T& a, const T& b) const;
+public:
+	TopK(std::size_t k, bool exact = true, Compare better = Compare());
+	/**
+	* Adds an element.
+	*/
+	void push(const T& x);
+	/**
+	* Adds all of the elements kept by other (e.g. counted by another thread), the result is the same as pushing everything to one TopK.
+	*/
+	void merge(const TopK<T, Compare>& other);
+	/**
+	* Outputs the number of the kept elements (with the ties).
+	*/
+	std::size_t size() const;
+	/**
+	* Outputs the kept elements, the best one first. The ties are at the end.
+	*/
+	std::vector<T> sorted() const;
+};
+
+template<typename T, typename Compare>
+TopK<T, Compare>::TopK(std::size_t k, bool exact, Compare better) : heap(), ties(), k(k), exact(exact), better(better) {
+	heap.reserve(k);
+}
+
+template<typename T, typename Compare>
+bool TopK<T, Compare>::equal(const T& a, const T& b) const {
+	return !better(a, b) and !better(b, a);
+}
+
+template<typename T, typename Compare>
+void TopK<T, Compare>::push(const T& x) {
+	if (k == 0)
+		return;
+	//with better as the order of the heap the worst element is on the top
+	if (heap.size() < k) {
+		heap.push_back(x);
+		std::push_heap(heap.begin(), heap.end(), better);
+		return;
+	}
+	if (better(x, heap.front())) {
+		std::pop_heap(heap.begin(), heap.end(), better);
+		T worst = std::move(heap.back());
+		heap.back() = x;
+		std::push_heap(heap.begin(), heap.end(), better);
+		if (exact)
+			return;
+		//the old top is a tie of the new one only when they are equal, otherwise all of the ties are worse now
+		if (equal(worst, heap.front()))
+			ties.push_back(std::move(worst));
+		else
+			ties.clear();
+	}
+	else if (!exact and equal(x, heap.front())) {
+		ties.push_back(x);
+	}
+}
+
+template<typename T, typename Compare>
+void TopK<T, Compare>::merge(const TopK<T, Compare>& other) {
+	for (const T& x : other.heap)
+		push(x);
+	for (const T& x : other.ties)
+		push(x);
+}
+
+template<typename T, typename Compare>
+std::size_t TopK<T, Compare>::size() const {
+	return heap.size() + ties.size();
+}
+
+template<typename T, typename Compare>
+std::vector<T> TopK<T, Compare>::sorted() const {
+	std::vector<T> result(heap);
+	std::sort_heap(result.begin(), result.end(), better);
+	result.insert(result.end(), ties.begin(), ties.end());
+	return result;
+}
+
+/**
+* Functionality: Outputs iterators to the k best elements of the dictionary (with the ties of the k-th one when exact is false), the best one first.
+* Approche: One pass through the elements with a TopK, O(n log k). With more threads every thread takes an equal part of the
+* order (its first element is found with select) into its own TopK and the heaps are merged at the end.
+* param[in] d : Dictionary, it can not be changed meanwhile.
+* param[in] k : Number of the elements.
+* param[in] exact : Whether the ties of the k-th element are skipped.
+* param[in] better : better(const iterator& a, const iterator& b) is true when a should be before b.
+* param[in] threads : Number of threads.
+*/
+template<typename Dict, typename Compare>
+std::vector<typename Dict::iterator> topK(const Dict& d, std::size_t k, bool exact, Compare better, unsigned threads = 1) {
+	typedef typename Dict::iterator iterator;
+	if (threads < 2 or d.size() < 2 * std::size_t(threads)) {
+		TopK<iterator, Compare> top(k, exact, better);
+		for (iterator it = d.begin(); it != d.end(); ++it)
+			top.push(it);
+		return top.sorted();
+	}
+	std::vector<TopK<iterator, Compare>> parts(threads, TopK<iterator, Compare>(k, exact, better));
+	std::vector<std::thread> workers;
+	for (unsigned i = 0; i < threads; ++i) {
+		workers.emplace_back([&d, &parts, i, threads]() {
+			std::size_t from = d.size() * i / threads, to = d.size() * (i + 1) / threads;
+			iterator it = d.select(from);
+			for (std::size_t j = from; j < to; ++j, ++it)
+				parts[i].push(it);
+		});
+	}
+	for (std::thread& worker : workers)
+		worker.join();
+	for (unsigned i = 1; i < threads; ++i)
+		parts[0].merge(parts[i]);
+	return parts[0].sorted();
+}
@@ -0,0 +1,418 @@
+#pragma once
+#include<cstddef>
+#include<cstdint>
+#include<cerrno>
+#include<istream>
+#include<string>
+#include<string_view>
+#include<utility>
+#include<vector>
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include<windows.h>
+#include<io.h>
+#else
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+#include<intrin.h>
+#endif
+#if defined(__AVX2__)
+#include<immintrin.h>
+#define WORDSCANNER_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include<emmintrin.h>
+#define WORDSCANNER_SSE2
+#endif
+
+/**
+* Outputs true for the letters which make a word (capital and lower case letters).
+*/
+inline bool isLetter(char c) {
+	return (c >= 'a' and c <= 'z') or (c >= 'A' and c <= 'Z');
+}
+
+namespace WordScannerDetail {
+	/**
+	* Outputs a mask with the bit i set when p[i] is a letter, 64 bytes are classified at once.
+	* c | 0x20 maps capital letters onto the lower case ones and no other byte onto them, so one range check is enough.
+	* Bytes above 0x7f are negative for the signed comparisons of SSE2/AVX2, so they are not letters either.
+	*/
+	inline std::uint64_t letterMask(const char* p) {
+#if defined(WORDSCANNER_AVX2)
+		const __m256i lower = _mm256_set1_epi8(0x20), from = _mm256_set1_epi8('a' - 1), to = _mm256_set1_epi8('z' + 1);
+		std::uint64_t mask = 0;
+		for (int i = 0; i < 64; i += 32) {
+			__m256i x = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), lower);
+			__m256i letter = _mm256_and_si256(_mm256_cmpgt_epi8(x, from), _mm256_cmpgt_epi8(to, x));
+			mask |= std::uint64_t(std::uint32_t(_mm256_movemask_epi8(letter))) << i;
+		}
+		return mask;
+#elif defined(WORDSCANNER_SSE2)
+		const __m128i lower = _mm_set1_epi8(0x20), from = _mm_set1_epi8('a' - 1), to = _mm_set1_epi8('z' + 1);
+		std::uint64_t mask = 0;
+		for (int i = 0; i < 64; i += 16) {
+			__m128i x = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), lower);
+			__m128i letter = _mm_and_si128(_mm_cmpgt_epi8(x, from), _mm_cmplt_epi8(x, to));
+			mask |= std::uint64_t(_mm_movemask_epi8(letter)) << i;
+		}
+		return mask;
+#else
+		std::uint64_t mask = 0;
+		for (int i = 0; i < 64; ++i)
+			mask |= std::uint64_t(isLetter(p[i])) << i;
+		return mask;
+#endif
+	}
+	/**
+	* Outputs the index of the lowest set bit, mask is not 0.
+	*/
+	inline unsigned lowestBit(std::uint64_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+		unsigned long index;
+		_BitScanForward64(&index, mask);
+		return unsigned(index);
+#else
+		return unsigned(__builtin_ctzll(mask));
+#endif
+	}
+}
+
+/**
+* Functionality: Calls method(std::string_view) for every word of text, the views point into text, nothing is copied.
+* Approche: Every 64 bytes are turned into a mask of letters, the bits where a word begins or ends are found
+* by comparing the mask with itself shifted by one byte, so only the boundaries are visited, not every byte.
+* The last bytes (less than 64) are checked one by one.
+* param[in] text : Text to scan.
+* param[in] method : Method called with every word in order.
+*/
+template<class rule>
+void forEachWord(std::string_view text, rule method) {
+	const char* data = text.data();
+	const std::size_t size = text.size();
+	std::size_t start = 0, i = 0;
+	//bit 63 tells if the last byte of the previous block was a letter
+	std::uint64_t previous = 0;
+	for (; i + 64 <= size; i += 64) {
+		std::uint64_t letters = WordScannerDetail::letterMask(data + i);
+		std::uint64_t shifted = letters << 1 | previous >> 63;
+		//a set bit is either the first letter of a word or the first non-letter after one
+		std::uint64_t edges = letters ^ shifted;
+		previous = letters;
+		while (edges) {
+			unsigned bit = WordScannerDetail::lowestBit(edges);
+			if (letters >> bit & 1)
+				start = i + bit;
+			else
+				method(std::string_view(data + start, i + bit - start));
+			edges &= edges - 1;
+		}
+	}
+	bool word = previous >> 63;
+	for (; i < size; ++i) {
+		bool letter = isLetter(data[i]);
+		if (letter and !word)
+			start = i;
+		else if (!letter and word)
+			method(std::string_view(data + start, i - start));
+		word = letter;
+	}
+	if (word)
+		method(std::string_view(data + start, size - start));
+}
+
+/**
+* \brief Tokenizer for a text which comes in blocks of any size.
+* A word cut by the end of a block is kept until the block where it ends, so only that word is copied,
+* the other ones are views of the block.
+*/
+class WordSplitter {
+	std::string rest;
+public:
+	/**
+	* Functionality: Calls method(std::string_view) for every word which ends in block.
+	* param[in] block : Next part of the text, it does not have to be valid after the call.
+	* param[in] method : Method called with every word in order.
+	*/
+	template<class rule>
+	void feed(std::string_view block, rule method);
+	/**
+	* Functionality: Calls method for the last word if the text ends with a letter, to be called at the end of the text.
+	*/
+	template<class rule>
+	void finish(rule method);
+};
+
+template<class rule>
+void WordSplitter::feed(std::string_view block, rule method) {
+	std::size_t first = 0;
+	if (!rest.empty()) {
+		while (first < block.size() and isLetter(block[first]))
+			++first;
+		rest.append(block.data(), first);
+		if (first == block.size())
+			return;
+		method(std::string_view(rest));
+		rest.clear();
+	}
+	//the word at the end of the block may continue in the next one
+	std::size_t last = block.size();
+	while (last > first and isLetter(block[last - 1]))
+		--last;
+	forEachWord(block.substr(first, last - first), method);
+	rest.append(block.data() + last, block.size() - last);
+}
+
+template<class rule>
+void WordSplitter::finish(rule method) {
+	if (!rest.empty())
+		method(std::string_view(rest));
+	rest.clear();
+}
+
+/**
+* Functionality: Calls method(std::string_view) for every word of the stream. The stream is read in blocks of bufferSize bytes
+* to one buffer, so the memory does not depend on the length of the lines (only on the length of the longest word).
+* param[in] in : Stream to read (file, std::cin, ...).
+* param[in] method : Method called with every word in order, the view is valid only during the call.
+* param[in] bufferSize : Size of the buffer.
+*/
+template<class rule>
+void forEachWord(std::istream& in, rule method, std::size_t bufferSize = 1 << 16) {
+	std::vector<char> buffer(bufferSize ? bufferSize : 1);
+	WordSplitter splitter;
+	while (in) {
+		in.read(buffer.data(), std::streamsize(buffer.size()));
+		splitter.feed(std::string_view(buffer.data(), std::size_t(in.gcount())), method);
+	}
+	splitter.finish(method);
+}
+
+/**
+* \brief Counts the words of a stream (std::istream or a file descriptor: a pipe, a socket, stdin) with one buffer of a fixed size.
+* Counts is the dictionary of the counts, its upsert has to accept std::string_view (a transparent comparator),
+* e.g. Dictionary<std::string, int, ThreeWayCompare<>>. The stream can be read all at once with readAll or block by block with read,
+* the counts can be looked at between the blocks. At the end of the text finish() has to be called.
+*/
+template<typename Counts>
+class WordCounter {
+	Counts counts;
+	WordSplitter splitter;
+	std::vector<char> buffer;
+	unsigned long long bytes;
+	void count(std::size_t read);
+public:
+	explicit WordCounter(std::size_t bufferSize = 1 << 16);
+	/**
+	* Reads one block from the stream and counts its words, outputs the number of bytes read (0 at the end of the stream).
+	*/
+	std::size_t read(std::istream& in);
+	/**
+	* Same as read(std::istream&) for a file descriptor, throws when reading fails.
+	*/
+	std::size_t read(int descriptor);
+	/**
+	* Functionality: Reads and counts the whole stream and calls finish().
+	* param[in] source : std::istream or a file descriptor.
+	* param[in] every : Number of bytes between the snapshots.
+	* param[in] snapshot : Method called with the counts so far (const Counts&) every time another every bytes were read.
+	*/
+	template<class Source, class Snapshot>
+	void readAll(Source&& source, unsigned long long every, Snapshot snapshot);
+	/**
+	* Reads and counts the whole stream and calls finish().
+	*/
+	template<class Source>
+	void readAll(Source&& source);
+	/**
+	* Counts the last word, to be called at the end of the text.
+	*/
+	void finish();
+	/**
+	* Outputs the counts so far, a word which may continue in the next block is not counted yet.
+	*/
+	const Counts& get() const;
+	/**
+	* Outputs the counts, the counter is left empty.
+	*/
+	Counts release();
+	/**
+	* Outputs the number of bytes read.
+	*/
+	unsigned long long bytesRead() const;
+};
+
+template<typename Counts>
+WordCounter<Counts>::WordCounter(std::size_t bufferSize) : counts(), splitter(), buffer(bufferSize ? bufferSize : 1), bytes(0) {}
+
+template<typename Counts>
+void WordCounter<Counts>::count(std::size_t read) {
+	bytes += read;
+	splitter.feed(std::string_view(buffer.data(), read), [this](std::string_view word) {
+		counts.upsert(word, [](auto& count) { ++count; });
+	});
+}
+
+template<typename Counts>
+std::size_t WordCounter<Counts>::read(std::istream& in) {
+	if (!in)
+		return 0;
+	in.read(buffer.data(), std::streamsize(buffer.size()));
+	std::size_t read = std::size_t(in.gcount());
+	count(read);
+	return read;
+}
+
+template<typename Counts>
+std::size_t WordCounter<Counts>::read(int descriptor) {
+	while (true) {
+#if defined(_WIN32)
+		int read = _read(descriptor, buffer.data(), unsigned(buffer.size() < 0x40000000 ? buffer.size() : 0x40000000));
+#else
+		ssize_t read = ::read(descriptor, buffer.data(), buffer.size());
+#endif
+		if (read >= 0) {
+			count(std::size_t(read));
+			return std::size_t(read);
+		}
+		if (errno != EINTR)
+			throw "Could not read the stream!";
+	}
+}
+
+template<typename Counts>
+template<class Source, class Snapshot>
+void WordCounter<Counts>::readAll(Source&& source, unsigned long long every, Snapshot snapshot) {
+	unsigned long long next = bytes + every;
+	while (read(source)) {
+		if (every and bytes >= next) {
+			snapshot(static_cast<const Counts&>(counts));
+			while (next <= bytes)
+				next += every;
+		}
+	}
+	finish();
+}
+
+template<typename Counts>
+template<class Source>
+void WordCounter<Counts>::readAll(Source&& source) {
+	readAll(source, 0, [](const Counts&) {});
+}
+
+template<typename Counts>
+void WordCounter<Counts>::finish() {
+	splitter.finish([this](std::string_view word) {
+		counts.upsert(word, [](auto& count) { ++count; });
+	});
+}
+
+template<typename Counts>
+const Counts& WordCounter<Counts>::get() const {
+	return counts;
+}
+
+template<typename Counts>
+Counts WordCounter<Counts>::release() {
+	Counts result = std::move(counts);
+	counts = Counts();
+	return result;
+}
+
+template<typename Counts>
+unsigned long long WordCounter<Counts>::bytesRead() const {
+	return bytes;
+}
+
+/**
+* \brief Read-only memory mapping of a whole file, the file is unmapped by the destructor.
+* Nothing is read until the bytes are touched, the kernel is asked to read ahead (sequential access).
+*/
+class MappedFile {
+	const char* data;
+	std::size_t length;
+public:
+	/**
+	* Maps the file, throws when it cannot be opened or mapped. An empty file gives an empty view.
+	*/
+	explicit MappedFile(const std::string& filename);
+	MappedFile(const MappedFile& x) = delete;
+	MappedFile& operator=(const MappedFile& x) = delete;
+	~MappedFile();
+	/**
+	* Outputs the content of the file.
+	*/
+	std::string_view view() const;
+	/**
+	* Outputs the size of the file in bytes.
+	*/
+	std::size_t size() const;
+};
+
+inline MappedFile::MappedFile(const std::string& filename) : data(nullptr), length(0) {
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		throw "Could not open the file!";
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size)) {
+		CloseHandle(file);
+		throw "Could not open the file!";
+	}
+	length = std::size_t(size.QuadPart);
+	if (length) {
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping) {
+			data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+			CloseHandle(mapping);
+		}
+	}
+	CloseHandle(file);
+	if (length and !data)
+		throw "Could not map the file!";
+#else
+	int file = open(filename.c_str(), O_RDONLY);
+	if (file < 0)
+		throw "Could not open the file!";
+	struct stat status;
+	if (fstat(file, &status) != 0) {
+		close(file);
+		throw "Could not open the file!";
+	}
+	length = std::size_t(status.st_size);
+	if (length) {
+		void* memory = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file, 0);
+		if (memory == MAP_FAILED) {
+			close(file);
+			throw "Could not map the file!";
+		}
+		madvise(memory, length, MADV_SEQUENTIAL);
+		data = static_cast<const char*>(memory);
+	}
+	//the mapping stays valid after closing the descriptor
+	close(file);
+#endif
+}
+
+inline MappedFile::~MappedFile() {
+	if (!data)
+		return;
+#if defined(_WIN32)
+	UnmapViewOfFile(data);
+#else
+	munmap(const_cast<char*>(data), length);
+#endif
+}
+
+inline std::string_view MappedFile::view() const {
+	return std::string_view(data, length);
+}
+
+inline std::size_t MappedFile::size() const {
+	return length;
+}
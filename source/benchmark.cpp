@@ -0,0 +1,872 @@
+//Benchmarks of the dictionaries against std::map and std::unordered_map, a separate executable:
+//g++ -std=c++17 -O2 -pthread -I. benchmark.cpp -o benchmark
+//./benchmark [--format csv|json] [--max-size N] [--sizes a,b,...] [--suite core|extra|all] [--filter name] [--seed s] [--output file]
+//Every row is: container, key type, distribution, size, operation, threads, ops, seconds, ns/op, ops/s,
+//peak RSS (kB) and the number and bytes of the allocations made by the operation.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#if defined(_MSC_VER)
+#pragma comment(lib, "psapi.lib")
+#endif
+#else
+#include <sys/resource.h>
+#endif
+#if defined(__linux__)
+#include <malloc.h>
+#endif
+#include"Dictionary.h"
+#include"BPlusTree.h"
+#include"CompactDictionary.h"
+#include"ConcurrentDictionary.h"
+#include"PersistentDictionary.h"
+#include"ShardedDictionary.h"
+#include"WordScanner.h"
+#include"TopK.h"
+#include"FrequencyDictionary.h"
+#include"PoolAllocator.h"
+#include"AllocationCounter.h"
+
+//peak resident set size in kB, on Linux it is reset before every case, elsewhere it is the peak of the whole run
+long long peakKilobytes() {
+#if defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return std::atoll(line.c_str() + 6);
+        }
+    }
+    return 0;
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return (long long)(counters.PeakWorkingSetSize / 1024);
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+void resetPeak() {
+#if defined(__GLIBC__)
+    //memory freed by the previous case goes back to the system, so it is not counted again
+    malloc_trim(0);
+#endif
+#if defined(__linux__)
+    //5 resets the peak (VmHWM) to the current size
+    std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+}
+
+struct Options {
+    std::string format = "csv";
+    std::vector<std::size_t> sizes;
+    std::string suite = "all";
+    std::string filter;
+    std::uint64_t seed = 1;
+    std::string output;
+};
+
+//one line of the results
+struct Row {
+    std::string container, key, distribution, operation;
+    std::size_t size;
+    unsigned threads;
+    unsigned long long ops;
+    double seconds;
+    long long peak;
+    unsigned long long allocations, bytes;
+};
+
+class Report {
+    std::ostream& out;
+    bool json;
+    bool first;
+public:
+    Report(std::ostream& out, bool json) : out(out), json(json), first(true) {
+        if (json) {
+            out << "[\n";
+        }
+        else {
+            out << "container,key,distribution,size,operation,threads,ops,seconds,ns_per_op,ops_per_s,peak_rss_kb,allocations,allocated_bytes\n";
+        }
+    }
+    ~Report() {
+        if (json) {
+            out << "\n]\n";
+        }
+        out.flush();
+    }
+    void add(const Row& row) {
+        double nanoseconds = row.ops ? row.seconds * 1e9 / double(row.ops) : 0;
+        double throughput = row.seconds > 0 ? double(row.ops) / row.seconds : 0;
+        if (json) {
+            out << (first ? "" : ",\n") << "{\"container\":\"" << row.container << "\",\"key\":\"" << row.key << "\",\"distribution\":\"" << row.distribution
+                << "\",\"size\":" << row.size << ",\"operation\":\"" << row.operation << "\",\"threads\":" << row.threads << ",\"ops\":" << row.ops
+                << ",\"seconds\":" << row.seconds << ",\"ns_per_op\":" << nanoseconds << ",\"ops_per_s\":" << throughput << ",\"peak_rss_kb\":" << row.peak
+                << ",\"allocations\":" << row.allocations << ",\"allocated_bytes\":" << row.bytes << "}";
+        }
+        else {
+            out << row.container << "," << row.key << "," << row.distribution << "," << row.size << "," << row.operation << "," << row.threads << ","
+                << row.ops << "," << row.seconds << "," << nanoseconds << "," << throughput << "," << row.peak << "," << row.allocations << "," << row.bytes << "\n";
+        }
+        out.flush();
+        first = false;
+    }
+};
+
+//measures one operation: time, allocations and the peak RSS so far
+class Measure {
+    Row row;
+    std::chrono::steady_clock::time_point start;
+    unsigned long long startAllocations, startBytes;
+public:
+    Measure(const Row& base, const std::string& operation, unsigned long long ops, unsigned threads = 1) : row(base) {
+        row.operation = operation;
+        row.ops = ops;
+        row.threads = threads;
+        startAllocations = allocations.load();
+        startBytes = allocatedBytes.load();
+        start = std::chrono::steady_clock::now();
+    }
+    Row stop() {
+        row.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        row.allocations = allocations.load() - startAllocations;
+        row.bytes = allocatedBytes.load() - startBytes;
+        row.peak = peakKilobytes();
+        return row;
+    }
+};
+
+//Zipf distribution of ranks 1..n with exponent s (rejection-inversion sampling, no table, so it works for any n)
+class Zipf {
+    double s, n, integralFirst, integralLast, bound;
+    static double helper1(double x) { return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x)); }
+    static double helper2(double x) { return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1 + x * 0.5 * (1 + x / 3 * (1 + 0.25 * x)); }
+    double h(double x) const { return std::exp(-s * std::log(x)); }
+    double integral(double x) const { double l = std::log(x); return helper2((1 - s) * l) * l; }
+    double inverse(double x) const { double t = std::max(x * (1 - s), -1.0); return std::exp(helper1(t) * x); }
+public:
+    Zipf(std::size_t count, double exponent = 0.99) : s(exponent), n(double(count)) {
+        integralFirst = integral(1.5) - 1;
+        integralLast = integral(n + 0.5);
+        bound = 2 - inverse(integral(2.5) - h(2));
+    }
+    template<typename Random>
+    std::size_t operator()(Random& random) {
+        std::uniform_real_distribution<double> uniform(0, 1);
+        while (true) {
+            double u = integralLast + uniform(random) * (integralFirst - integralLast);
+            double x = inverse(u);
+            double k = std::floor(x + 0.5);
+            k = std::min(std::max(k, 1.0), n);
+            if (k - x <= bound or u >= integral(k + 0.5) - h(k)) {
+                return std::size_t(k);
+            }
+        }
+    }
+};
+
+template<typename Key>
+Key makeKey(std::size_t i);
+template<>
+int makeKey<int>(std::size_t i) {
+    return int(i);
+}
+template<>
+std::string makeKey<std::string>(std::size_t i) {
+    //zero padded, so the order of the strings is the order of the numbers
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "key%010llu", (unsigned long long)i);
+    return buffer;
+}
+
+//orders of the keys (indices to the key array) used by the operations of one distribution:
+//sequential is 0..n-1, random is a random permutation, zipf inserts in random order and then finds and removes Zipf distributed keys
+struct Workload {
+    std::vector<std::uint32_t> insert, find, remove;
+    Workload(const std::string& distribution, std::size_t n, std::mt19937_64& random) {
+        std::vector<std::uint32_t> order(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            order[i] = std::uint32_t(i);
+        }
+        if (distribution == "sequential") {
+            insert = find = remove = order;
+            return;
+        }
+        std::shuffle(order.begin(), order.end(), random);
+        insert = order;
+        if (distribution == "random") {
+            std::shuffle(order.begin(), order.end(), random);
+            find = order;
+            std::shuffle(order.begin(), order.end(), random);
+            remove = order;
+            return;
+        }
+        //the rank is mapped through the insert order, so the hot keys are spread over the whole range
+        Zipf zipf(n);
+        find.resize(n);
+        remove.resize(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            find[i] = insert[zipf(random) - 1];
+            remove[i] = insert[zipf(random) - 1];
+        }
+    }
+};
+
+//operations of a container, the dictionaries of this repository share the same API
+template<typename C>
+struct Operations {
+    static const bool iterable = true;
+    template<typename T, typename Key>
+    static void insert(T& c, const Key& key, int info) { c.insert(key, info); }
+    template<typename T, typename Key>
+    static bool find(const T& c, const Key& key) { return c.contains(key); }
+    template<typename T, typename Key>
+    static void remove(T& c, const Key& key) { c.remove(key); }
+    template<typename T>
+    static long long iterate(T& c) {
+        long long sum = 0;
+        for (auto it = c.begin(); it != c.end(); ++it) {
+            sum += it.getInfo();
+        }
+        return sum;
+    }
+};
+template<typename Key, typename Info>
+struct Operations<std::map<Key, Info>> {
+    typedef std::map<Key, Info> C;
+    static const bool iterable = true;
+    static void insert(C& c, const Key& key, int info) { c.emplace(key, info); }
+    static bool find(const C& c, const Key& key) { return c.find(key) != c.end(); }
+    static void remove(C& c, const Key& key) { c.erase(key); }
+    static long long iterate(C& c) {
+        long long sum = 0;
+        for (auto& element : c) {
+            sum += element.second;
+        }
+        return sum;
+    }
+};
+template<typename Key, typename Info>
+struct Operations<std::unordered_map<Key, Info>> {
+    typedef std::unordered_map<Key, Info> C;
+    static const bool iterable = true;
+    static void insert(C& c, const Key& key, int info) { c.emplace(key, info); }
+    static bool find(const C& c, const Key& key) { return c.find(key) != c.end(); }
+    static void remove(C& c, const Key& key) { c.erase(key); }
+    static long long iterate(C& c) {
+        long long sum = 0;
+        for (auto& element : c) {
+            sum += element.second;
+        }
+        return sum;
+    }
+};
+template<typename Key, typename Info, typename Compare>
+struct Operations<ConcurrentDictionary<Key, Info, Compare>> : Operations<Dictionary<Key, Info, Compare>> {
+    //there are no iterators, only toDictionary
+    static const bool iterable = false;
+};
+
+//the result is kept here, so the compiler can not drop the loops
+static volatile long long sink = 0;
+
+//insert, find, iterate and remove of n keys, repeated for small n so every row takes some time
+template<typename C, typename Key>
+void runContainer(Report& report, const std::string& name, const std::string& keyName, const std::string& distribution,
+    const std::vector<Key>& keys, const Workload& work) {
+    typedef Operations<C> Ops;
+    std::size_t n = keys.size();
+    std::size_t rounds = std::max<std::size_t>(1, 100000 / n);
+    Row base{ name, keyName, distribution, "", n, 1, 0, 0, 0, 0, 0 };
+    Row insert = base, find = base, iterate = base, remove = base;
+    resetPeak();
+    for (std::size_t round = 0; round < rounds; ++round) {
+        C* c = new C();
+        auto add = [](Row& total, const Row& part) {
+            total.operation = part.operation;
+            total.ops += part.ops;
+            total.seconds += part.seconds;
+            total.allocations += part.allocations;
+            total.bytes += part.bytes;
+            total.peak = std::max(total.peak, part.peak);
+        };
+        Measure m1(base, "insert", n);
+        for (std::uint32_t i : work.insert) {
+            Ops::insert(*c, keys[i], int(i));
+        }
+        add(insert, m1.stop());
+        Measure m2(base, "find", n);
+        long long found = 0;
+        for (std::uint32_t i : work.find) {
+            found += Ops::find(*c, keys[i]);
+        }
+        add(find, m2.stop());
+        if constexpr (Ops::iterable) {
+            Measure m3(base, "iterate", n);
+            sink = sink + Ops::iterate(*c);
+            add(iterate, m3.stop());
+        }
+        Measure m4(base, "remove", n);
+        for (std::uint32_t i : work.remove) {
+            Ops::remove(*c, keys[i]);
+        }
+        add(remove, m4.stop());
+        delete c;
+        sink = sink + found;
+    }
+    report.add(insert);
+    report.add(find);
+    if (Ops::iterable) {
+        report.add(iterate);
+    }
+    report.add(remove);
+}
+
+//the frozen dictionary is built from a filled Dictionary, it has no insert or remove
+template<typename Key>
+void runFrozen(Report& report, const std::string& keyName, const std::string& distribution, const std::vector<Key>& keys, const Workload& work) {
+    std::size_t n = keys.size();
+    Row base{ "FrozenDictionary", keyName, distribution, "", n, 1, 0, 0, 0, 0, 0 };
+    resetPeak();
+    Dictionary<Key, int> source;
+    for (std::uint32_t i : work.insert) {
+        source.insert(keys[i], int(i));
+    }
+    Measure build(base, "freeze", n);
+    FrozenDictionary<Key, int> frozen = source.freeze();
+    report.add(build.stop());
+    source.clear();
+    std::size_t rounds = std::max<std::size_t>(1, 100000 / n);
+    Measure find(base, "find", n * rounds);
+    long long found = 0;
+    for (std::size_t round = 0; round < rounds; ++round) {
+        for (std::uint32_t i : work.find) {
+            found += frozen.contains(keys[i]);
+        }
+    }
+    report.add(find.stop());
+    Measure iterate(base, "iterate", n);
+    for (auto it = frozen.begin(); it != frozen.end(); ++it) {
+        found += it.getInfo();
+    }
+    report.add(iterate.stop());
+    sink = sink + found;
+}
+
+bool selected(const Options& options, const std::string& name) {
+    return options.filter.empty() or name.find(options.filter) != std::string::npos;
+}
+
+template<typename Key>
+void runCore(Report& report, const Options& options, const std::string& keyName) {
+    typedef Dictionary<Key, int> Avl;
+    typedef Dictionary<Key, int, ThreeWayCompare<>> AvlThreeWay;
+    typedef Dictionary<Key, int, std::less<Key>, PoolAllocator<std::pair<const Key, int>>> AvlPool;
+    for (std::size_t n : options.sizes) {
+        std::vector<Key> keys(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            keys[i] = makeKey<Key>(i);
+        }
+        for (const char* distribution : { "sequential", "random", "zipf" }) {
+            std::mt19937_64 random(options.seed);
+            Workload work(distribution, n, random);
+            std::cerr << keyName << " " << distribution << " " << n << std::endl;
+            if (selected(options, "Dictionary")) runContainer<Avl>(report, "Dictionary", keyName, distribution, keys, work);
+            if (selected(options, "Dictionary/ThreeWayCompare")) runContainer<AvlThreeWay>(report, "Dictionary/ThreeWayCompare", keyName, distribution, keys, work);
+            if (selected(options, "Dictionary/PoolAllocator")) runContainer<AvlPool>(report, "Dictionary/PoolAllocator", keyName, distribution, keys, work);
+            if (selected(options, "BPlusDictionary")) runContainer<BPlusDictionary<Key, int>>(report, "BPlusDictionary", keyName, distribution, keys, work);
+            if (selected(options, "CompactDictionary")) runContainer<CompactDictionary<Key, int>>(report, "CompactDictionary", keyName, distribution, keys, work);
+            if (selected(options, "ConcurrentDictionary")) runContainer<ConcurrentDictionary<Key, int>>(report, "ConcurrentDictionary", keyName, distribution, keys, work);
+            if (selected(options, "ShardedDictionary")) runContainer<ShardedDictionary<Key, int>>(report, "ShardedDictionary", keyName, distribution, keys, work);
+            if (selected(options, "PersistentDictionary")) runContainer<PersistentDictionary<Key, int>>(report, "PersistentDictionary", keyName, distribution, keys, work);
+            if (selected(options, "FrozenDictionary")) runFrozen<Key>(report, keyName, distribution, keys, work);
+            if (selected(options, "std::map")) runContainer<std::map<Key, int>>(report, "std::map", keyName, distribution, keys, work);
+            if (selected(options, "std::unordered_map")) runContainer<std::unordered_map<Key, int>>(report, "std::unordered_map", keyName, distribution, keys, work);
+        }
+    }
+}
+
+//n random inserts followed by clear(), a node per heap allocation (std::allocator) against the pool,
+//the peak RSS of the insert row is the memory of the whole tree
+template<typename C>
+void runAllocator(Report& report, const std::string& name, const std::vector<int>& keys, bool reserve) {
+    std::size_t n = keys.size();
+    Row base{ name, "int", "random", "", n, 1, 0, 0, 0, 0, 0 };
+    resetPeak();
+    C c;
+    Measure m1(base, reserve ? "reserve+insert" : "insert", n);
+    if (reserve) {
+        c.reserve(n);
+    }
+    for (int key : keys) {
+        c.insert(key, key);
+    }
+    report.add(m1.stop());
+    Measure m2(base, "clear", n);
+    c.clear();
+    report.add(m2.stop());
+}
+
+//runs method(thread) on threads threads and waits for them
+template<typename Method>
+void parallel(unsigned threads, Method method) {
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back(method, t);
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+//scaling of the concurrent counters, top-k, the frequency index, word counting, snapshots and range aggregates
+void runExtra(Report& report, const Options& options) {
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (std::size_t n : options.sizes) {
+        std::mt19937_64 random(options.seed);
+        Zipf zipf(n);
+        std::vector<int> hot(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            hot[i] = int(zipf(random) - 1);
+        }
+        std::cerr << "extra " << n << std::endl;
+        //n Zipf distributed increments split between the threads
+        for (unsigned threads : { 1u, 2u, 4u, 8u }) {
+            auto part = [n, threads](unsigned t) { return std::make_pair(n * t / threads, n * (t + 1) / threads); };
+            if (selected(options, "ShardedDictionary")) {
+                resetPeak();
+                ShardedDictionary<int, int> sharded;
+                Measure m(Row{ "ShardedDictionary", "int", "zipf", "", n, 1, 0, 0, 0, 0, 0 }, "increment", n, threads);
+                parallel(threads, [&](unsigned t) {
+                    for (std::size_t i = part(t).first; i < part(t).second; ++i) {
+                        sharded.increment(hot[i], 1);
+                    }
+                });
+                report.add(m.stop());
+            }
+            if (selected(options, "ConcurrentDictionary")) {
+                resetPeak();
+                ConcurrentDictionary<int, int> concurrent;
+                Measure m(Row{ "ConcurrentDictionary", "int", "zipf", "", n, 1, 0, 0, 0, 0, 0 }, "increment", n, threads);
+                parallel(threads, [&](unsigned t) {
+                    for (std::size_t i = part(t).first; i < part(t).second; ++i) {
+                        concurrent.upsert(hot[i], [](int& count) { ++count; });
+                    }
+                });
+                report.add(m.stop());
+            }
+            if (selected(options, "Dictionary+mutex")) {
+                resetPeak();
+                Dictionary<int, int> locked;
+                std::mutex lock;
+                Measure m(Row{ "Dictionary+mutex", "int", "zipf", "", n, 1, 0, 0, 0, 0, 0 }, "increment", n, threads);
+                parallel(threads, [&](unsigned t) {
+                    for (std::size_t i = part(t).first; i < part(t).second; ++i) {
+                        std::lock_guard<std::mutex> guard(lock);
+                        locked.upsert(hot[i], [](int& count) { ++count; });
+                    }
+                });
+                report.add(m.stop());
+            }
+        }
+        //n operations split between the threads on a tree prefilled with the even keys of [0, 2n):
+        //90% find, 5% insert and 5% remove of random keys, the lock-free reads against one global mutex
+        std::vector<int> mixKeys(n);
+        std::vector<unsigned char> mixOperations(n);
+        std::uniform_int_distribution<int> mixKey(0, int(2 * n) - 1);
+        std::uniform_int_distribution<int> percent(0, 99);
+        for (std::size_t i = 0; i < n; ++i) {
+            mixKeys[i] = mixKey(random);
+            int p = percent(random);
+            mixOperations[i] = p < 90 ? 0 : p < 95 ? 1 : 2;
+        }
+        std::vector<unsigned> mixThreads = { 1u, 2u, 4u, 8u };
+        if (std::find(mixThreads.begin(), mixThreads.end(), hardware) == mixThreads.end()) {
+            mixThreads.push_back(hardware);
+        }
+        for (unsigned threads : mixThreads) {
+            auto part = [n, threads](unsigned t) { return std::make_pair(n * t / threads, n * (t + 1) / threads); };
+            if (selected(options, "ConcurrentDictionary")) {
+                resetPeak();
+                ConcurrentDictionary<int, int> concurrent;
+                for (std::size_t i = 0; i < n; ++i) {
+                    concurrent.insert(int(2 * i), int(i));
+                }
+                Measure m(Row{ "ConcurrentDictionary", "int", "random", "", n, 1, 0, 0, 0, 0, 0 }, "90% find/5% insert/5% remove", n, threads);
+                std::atomic<long long> found(0);
+                parallel(threads, [&](unsigned t) {
+                    long long hits = 0;
+                    for (std::size_t i = part(t).first; i < part(t).second; ++i) {
+                        if (mixOperations[i] == 0) {
+                            hits += concurrent.contains(mixKeys[i]);
+                        }
+                        else if (mixOperations[i] == 1) {
+                            concurrent.insert(mixKeys[i], int(i));
+                        }
+                        else {
+                            concurrent.remove(mixKeys[i]);
+                        }
+                    }
+                    found += hits;
+                });
+                report.add(m.stop());
+                sink = sink + found;
+            }
+            if (selected(options, "Dictionary+mutex")) {
+                resetPeak();
+                Dictionary<int, int> locked;
+                for (std::size_t i = 0; i < n; ++i) {
+                    locked.insert(int(2 * i), int(i));
+                }
+                std::mutex lock;
+                Measure m(Row{ "Dictionary+mutex", "int", "random", "", n, 1, 0, 0, 0, 0, 0 }, "90% find/5% insert/5% remove", n, threads);
+                std::atomic<long long> found(0);
+                parallel(threads, [&](unsigned t) {
+                    long long hits = 0;
+                    for (std::size_t i = part(t).first; i < part(t).second; ++i) {
+                        std::lock_guard<std::mutex> guard(lock);
+                        if (mixOperations[i] == 0) {
+                            hits += locked.contains(mixKeys[i]);
+                        }
+                        else if (mixOperations[i] == 1) {
+                            locked.insert(mixKeys[i], int(i));
+                        }
+                        else {
+                            locked.remove(mixKeys[i]);
+                        }
+                    }
+                    found += hits;
+                });
+                report.add(m.stop());
+                sink = sink + found;
+            }
+        }
+        if (selected(options, "PoolAllocator")) {
+            std::vector<int> keys(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                keys[i] = int(i);
+            }
+            std::shuffle(keys.begin(), keys.end(), random);
+            typedef Dictionary<int, int, std::less<int>, PoolAllocator<std::pair<const int, int>>> Pooled;
+            runAllocator<Dictionary<int, int>>(report, "Dictionary/std::allocator", keys, false);
+            runAllocator<Pooled>(report, "Dictionary/PoolAllocator", keys, false);
+            runAllocator<Pooled>(report, "Dictionary/PoolAllocator", keys, true);
+        }
+        //n sorted keys inserted one by one against the bulk load (assign destroys the tree built before as well),
+        //and n Zipf distributed keys merged by assign with a combiner
+        if (selected(options, "Dictionary")) {
+            std::vector<std::pair<int, int>> sorted(n), unsorted(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                sorted[i] = std::make_pair(int(i), hot[i]);
+                unsorted[i] = std::make_pair(hot[i], 1);
+            }
+            Row base{ "Dictionary", "int", "sequential", "", n, 1, 0, 0, 0, 0, 0 };
+            resetPeak();
+            Dictionary<int, int> inserted;
+            Measure m1(base, "insert sorted", n);
+            for (const std::pair<int, int>& element : sorted) {
+                inserted.insert(element.first, element.second);
+            }
+            report.add(m1.stop());
+            Measure m2(base, "bulk construct", n);
+            Dictionary<int, int> built(sorted.begin(), sorted.end());
+            report.add(m2.stop());
+            Measure m3(base, "bulk assign", n);
+            built.assign(sorted.begin(), sorted.end());
+            report.add(m3.stop());
+            //== compares the shapes as well, the bulk load builds a perfectly balanced tree, so the elements are compared
+            bool same = inserted.size() == built.size();
+            for (auto it = inserted.begin(), other = built.begin(); same and it != inserted.end(); ++it, ++other) {
+                same = it.getKey() == other.getKey() and it.getInfo() == other.getInfo();
+            }
+            if (!same) {
+                throw "The bulk load differs!";
+            }
+            base.distribution = "zipf";
+            Dictionary<int, int> merged;
+            Measure m4(base, "bulk assign+combine", n);
+            merged.assign(unsorted.begin(), unsorted.end(), [](int& count, int more) { count += more; });
+            report.add(m4.stop());
+            sink = sink + inserted.size() + merged.size();
+        }
+        //top k of n elements with a scan (topK), exact or with all of the elements tied with the k-th one, and the top 100 from the frequency index
+        if (selected(options, "Dictionary")) {
+            resetPeak();
+            Dictionary<int, int> counts;
+            for (std::size_t i = 0; i < n; ++i) {
+                counts.insert(int(i), hot[i]);
+            }
+            auto better = [](const Dictionary<int, int>::iterator& a, const Dictionary<int, int>::iterator& b) { return a.getInfo() > b.getInfo(); };
+            for (std::size_t k : { 10, 1000, 100000 }) {
+                if (k > n) {
+                    break;
+                }
+                for (bool exact : { true, false }) {
+                    for (unsigned threads : { 1u, hardware }) {
+                        std::string operation = "topK(" + std::to_string(k) + (exact ? ")" : " with ties)");
+                        Measure m(Row{ "Dictionary", "int", "zipf", "", n, 1, 0, 0, 0, 0, 0 }, operation, n, threads);
+                        sink = sink + topK(counts, k, exact, better, threads).size();
+                        report.add(m.stop());
+                        if (hardware == 1) {
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+        if (selected(options, "FrequencyDictionary")) {
+            resetPeak();
+            FrequencyDictionary<int> frequencies;
+            Row base{ "FrequencyDictionary", "int", "zipf", "", n, 1, 0, 0, 0, 0, 0 };
+            Measure m1(base, "increment", n);
+            for (std::size_t i = 0; i < n; ++i) {
+                frequencies.increment(hot[i]);
+            }
+            report.add(m1.stop());
+            Measure m2(base, "top(100)", 1000);
+            for (int i = 0; i < 1000; ++i) {
+                sink = sink + frequencies.top(100).size();
+            }
+            report.add(m2.stop());
+        }
+        //counting n Zipf distributed keys: insert and *it += 1 when the key was there, find and then insert, a single upsert
+        if (selected(options, "Dictionary")) {
+            std::vector<std::string> words(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                words[i] = makeKey<std::string>(std::size_t(hot[i]));
+            }
+            Row base{ "Dictionary", "std::string", "zipf", "", n, 1, 0, 0, 0, 0, 0 };
+            resetPeak();
+            Dictionary<std::string, int> first, second, third;
+            Measure m1(base, "count insert+increment", n);
+            for (const std::string& word : words) {
+                Dictionary<std::string, int>::iterator it;
+                if (!first.insert(word, 1, it)) {
+                    *it += 1;
+                }
+            }
+            report.add(m1.stop());
+            Measure m2(base, "count find+insert", n);
+            for (const std::string& word : words) {
+                Dictionary<std::string, int>::iterator it = second.find(word);
+                if (!it.isNull()) {
+                    *it += 1;
+                }
+                else {
+                    second.insert(word, 1);
+                }
+            }
+            report.add(m2.stop());
+            Measure m3(base, "count upsert", n);
+            for (const std::string& word : words) {
+                third.upsert(word, [](int& count) { ++count; });
+            }
+            report.add(m3.stop());
+            if (first != third or second != third) {
+                throw "The counts differ!";
+            }
+            sink = sink + third.size();
+        }
+        //n Zipf distributed words from a vocabulary of n words, counted from a stream and only tokenized
+        if (selected(options, "WordCounter")) {
+            std::string text;
+            for (std::size_t i = 0; i < n; ++i) {
+                for (unsigned word = unsigned(hot[i]) + 1; word; word /= 26) {
+                    text += char('a' + word % 26);
+                }
+                text += i % 10 ? ' ' : '\n';
+            }
+            resetPeak();
+            Row base{ "WordCounter", "std::string", "zipf", "", n, 1, 0, 0, 0, 0, 0 };
+            Measure m1(base, "tokenize", n);
+            std::size_t words = 0;
+            forEachWord(std::string_view(text), [&words](std::string_view) { ++words; });
+            report.add(m1.stop());
+            std::istringstream in(text);
+            Measure m2(base, "count words", n);
+            WordCounter<Dictionary<std::string, int, ThreeWayCompare<>>> counter;
+            counter.readAll(in);
+            report.add(m2.stop());
+            sink = sink + words + counter.get().size();
+        }
+        //snapshot of n string keys
+        if (selected(options, "Dictionary")) {
+            resetPeak();
+            Dictionary<std::string, int> d;
+            for (std::size_t i = 0; i < n; ++i) {
+                d.insert(makeKey<std::string>(i), hot[i]);
+            }
+            Row base{ "Dictionary", "std::string", "sequential", "", n, 1, 0, 0, 0, 0, 0 };
+            const char* name = "benchmark_snapshot.bin";
+            Measure m1(base, "save", n);
+            d.save(name);
+            report.add(m1.stop());
+            Dictionary<std::string, int> loaded;
+            Measure m2(base, "load", n);
+            loaded.load(name);
+            report.add(m2.stop());
+            std::remove(name);
+            sink = sink + loaded.size();
+        }
+        //counts of a text file of n Zipf distributed words built again from the text (as readFile does) against loading their snapshot
+        if (selected(options, "Dictionary")) {
+            typedef Dictionary<std::string, int, ThreeWayCompare<>> Counts;
+            const char* text = "benchmark_text.txt";
+            const char* name = "benchmark_snapshot.bin";
+            {
+                std::ofstream out(text, std::ios::binary);
+                std::string line;
+                for (std::size_t i = 0; i < n; ++i) {
+                    for (unsigned word = unsigned(hot[i]) + 1; word; word /= 26) {
+                        line += char('a' + word % 26);
+                    }
+                    line += i % 10 ? ' ' : '\n';
+                }
+                out << line;
+            }
+            resetPeak();
+            Row base{ "Dictionary", "std::string", "zipf", "", n, 1, 0, 0, 0, 0, 0 };
+            Measure m1(base, "count text file", n);
+            std::ifstream in(text, std::ios::binary);
+            WordCounter<Counts> counter;
+            counter.readAll(in);
+            report.add(m1.stop());
+            in.close();
+            const Counts& counted = counter.get();
+            counted.save(name);
+            Counts loaded;
+            Measure m2(base, "load counts snapshot", counted.size());
+            loaded.load(name);
+            report.add(m2.stop());
+            std::remove(text);
+            std::remove(name);
+            if (loaded.size() != counted.size()) {
+                throw "The loaded counts differ!";
+            }
+            sink = sink + loaded.size();
+        }
+        //n sums of random ranges
+        if (selected(options, "AggregateDictionary")) {
+            resetPeak();
+            AggregateDictionary<int, int, SumAggregate<long long>> sums;
+            for (std::size_t i = 0; i < n; ++i) {
+                sums.insert(int(i), hot[i]);
+            }
+            std::uniform_int_distribution<int> position(0, int(n) - 1);
+            Measure m(Row{ "AggregateDictionary", "int", "random", "", n, 1, 0, 0, 0, 0, 0 }, "aggregate_range", n);
+            for (std::size_t i = 0; i < n; ++i) {
+                int lo = position(random), hi = position(random);
+                sink = sink + sums.aggregate(std::min(lo, hi), std::max(lo, hi));
+            }
+            report.add(m.stop());
+        }
+    }
+}
+
+bool parse(int argc, char** argv, Options& options) {
+    std::size_t maxSize = 1000000;
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        std::string value = argv[++i];
+        if (option == "--format" and (value == "csv" or value == "json")) {
+            options.format = value;
+        }
+        else if (option == "--max-size") {
+            maxSize = std::strtoull(value.c_str(), nullptr, 10);
+        }
+        else if (option == "--sizes") {
+            std::stringstream list(value);
+            std::string size;
+            while (std::getline(list, size, ',')) {
+                options.sizes.push_back(std::strtoull(size.c_str(), nullptr, 10));
+            }
+        }
+        else if (option == "--suite" and (value == "core" or value == "extra" or value == "all")) {
+            options.suite = value;
+        }
+        else if (option == "--filter") {
+            options.filter = value;
+        }
+        else if (option == "--seed") {
+            options.seed = std::strtoull(value.c_str(), nullptr, 10);
+        }
+        else if (option == "--output") {
+            options.output = value;
+        }
+        else {
+            return false;
+        }
+    }
+    if (options.sizes.empty()) {
+        for (std::size_t size = 1000; size <= maxSize; size *= 10) {
+            options.sizes.push_back(size);
+        }
+    }
+    //the orders of the keys are 32-bit indices
+    options.sizes.erase(std::remove_if(options.sizes.begin(), options.sizes.end(),
+        [](std::size_t size) { return size == 0 or size > 0xffffffffu; }), options.sizes.end());
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        std::cerr << "usage: benchmark [--format csv|json] [--max-size N] [--sizes a,b,...] [--suite core|extra|all] [--filter name] [--seed s] [--output file]" << std::endl;
+        return 1;
+    }
+    std::ofstream file;
+    if (!options.output.empty()) {
+        file.open(options.output);
+    }
+    std::ostream& out = options.output.empty() ? std::cout : file;
+    try {
+        Report report(out, options.format == "json");
+        if (options.suite != "extra") {
+            runCore<int>(report, options, "int");
+            runCore<std::string>(report, options, "std::string");
+        }
+        if (options.suite != "core") {
+            runExtra(report, options);
+        }
+    }
+    catch (const char* message) {
+        std::cerr << message << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -1,88 +1,174 @@
 ﻿#include <iostream>
 #include <fstream>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <functional>
 #include <list>
 #include <algorithm>
 #include <time.h>
+#include <cstdlib>
+#include <cstdio>
+#include <new>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <limits>
 #include"Dictionary.h"
+#include"PoolAllocator.h"
+#include"BPlusTree.h"
+#include"CompactDictionary.h"
+#include"ConcurrentDictionary.h"
+#include"PersistentDictionary.h"
+#include"ShardedDictionary.h"
+#include"WordScanner.h"
+#include"TopK.h"
+#include"FrequencyDictionary.h"
+#include"AllocationCounter.h"
 
-Dictionary<std::string, int> readFile(std::string filename) {
-    Dictionary<std::string, int> tree;
-    std::fstream file(filename);
+Dictionary<std::string, int, ThreeWayCompare<>> readFile(std::string filename) {
+    std::ifstream file(filename, std::ios::binary);
     if (!file) {
         throw "Could not open the file!";
     }
-    std::string line;
-    while (getline(file, line, ' ')) {
-        std::string local;
-        line += ";";
-        //according to the instructions I am considering only the letters
-        //the thing there is that each individual block can be at some point corrupted
-        //characters like: . , \ [ and so on may occure.
-        //we do need to prevent ourselves from that
-        for (unsigned int i = 0; i < line.size(); i++) {
-            if ((line[i] >= 'a' and line[i] <= 'z') or (line[i] >= 'A' and line[i] <= 'Z')) {
-                local += line[i];
+    //according to the instructions I am considering only the letters
+    //characters like: . , \ [ and so on may occure between them.
+    //the file is read in blocks to one buffer, so a long line does not have to fit in the memory,
+    //single descent for both a new and an already counted word,
+    //the word is a view of the buffer so a std::string is built only for a new word
+    WordCounter<Dictionary<std::string, int, ThreeWayCompare<>>> counter;
+    counter.readAll(file);
+    return counter.release();
+}
+
+//counts the words of the bytes [begin, end) of the file, neither begin nor end is inside of a word
+Dictionary<std::string, int, ThreeWayCompare<>> readChunk(const std::string& filename, std::streamoff begin, std::streamoff end) {
+    Dictionary<std::string, int, ThreeWayCompare<>> tree;
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        throw "Could not open the file!";
+    }
+    file.seekg(begin);
+    auto count = [&tree](std::string_view word) {
+        tree.upsert(word, [](int& count) { ++count; });
+    };
+    std::vector<char> buffer(1 << 16);
+    WordSplitter splitter;
+    while (begin < end) {
+        file.read(buffer.data(), std::streamsize(std::min<std::streamoff>(buffer.size(), end - begin)));
+        std::size_t read = std::size_t(file.gcount());
+        if (read == 0) {
+            break;
+        }
+        begin += read;
+        splitter.feed(std::string_view(buffer.data(), read), count);
+    }
+    splitter.finish(count);
+    return tree;
+}
+
+//same as readFile(filename), the file is split into threads byte ranges which are counted by separate threads to separate trees
+//and merged at the end
+Dictionary<std::string, int, ThreeWayCompare<>> readFile(std::string filename, unsigned threads) {
+    if (threads == 0) {
+        throw "Number of threads has to be positive!";
+    }
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw "Could not open the file!";
+    }
+    std::streamoff size = file.tellg();
+    //range i starts at the first non-letter after i * size / threads, so no word is split between two threads
+    std::vector<std::streamoff> bounds(threads + 1, size);
+    bounds[0] = 0;
+    for (unsigned i = 1; i < threads; ++i) {
+        std::streamoff pos = std::max(bounds[i - 1], size * i / threads);
+        file.clear();
+        file.seekg(pos);
+        char c;
+        while (pos < size and file.get(c) and isLetter(c)) {
+            ++pos;
+        }
+        bounds[i] = pos;
+    }
+    std::vector<Dictionary<std::string, int, ThreeWayCompare<>>> trees(threads);
+    std::vector<const char*> errors(threads, nullptr);
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back([&, i]() {
+            try {
+                trees[i] = readChunk(filename, bounds[i], bounds[i + 1]);
             }
-            else {
-                if (local.size() != 0) {
-                    Dictionary<std::string, int>::iterator it;
-                    if (!tree.insert(local, 1, it)) {
-                        *it += 1;
-                    }
-                    local.clear();
-                }
+            catch (const char* error) {
+                errors[i] = error;
             }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    for (const char* error : errors) {
+        if (error) {
+            throw error;
         }
     }
+    for (unsigned i = 1; i < threads; ++i) {
+        trees[0].merge_with(trees[i], [](int& count, int&& other) { count += other; });
+    }
+    return std::move(trees[0]);
+}
+
+//same as readFile(filename), the file is memory mapped and the words are counted straight from the mapping
+Dictionary<std::string, int, ThreeWayCompare<>> readMappedFile(std::string filename) {
+    Dictionary<std::string, int, ThreeWayCompare<>> tree;
+    MappedFile file(filename);
+    forEachWord(file.view(), [&tree](std::string_view word) {
+        tree.upsert(word, [](int& count) { ++count; });
+    });
     return tree;
 }
 
+//true when both of the containers have the same keys and infos in the same order
+template<class A, class B>
+bool sameElements(const A& a, const B& b) {
+    auto it = b.begin();
+    for (auto other = a.begin(); other != a.end(); ++other, ++it) {
+        if (it == b.end() or it.getKey() != other.getKey() or it.getInfo() != other.getInfo()) {
+            return false;
+        }
+    }
+    return it == b.end();
+}
+
 template<class rule>
-bool getFrequency(const Dictionary<std::string, int>& d,
-    std::list<Dictionary<std::string, int>::iterator>& elements,
+bool getFrequency(const Dictionary<std::string, int, ThreeWayCompare<>>& d,
+    std::list<Dictionary<std::string, int, ThreeWayCompare<>>::iterator>& elements,
     int max,
     bool exact,
-    rule method) 
+    rule method,
+    unsigned threads = 1)
 {
     if (max < 0)
         return false;
     //lets just make sure that elements is empty
     elements.clear();
-    //I do prefer to execute this method because it works in O(n) where n is a number of elements
-    //I am not using range based loop bacause in case of tree it in not O(n)
-    //we still do need the iterators because executeForAllNodes works only if
-    //it has const_iterator on the input
-    d.executeForAllNodes([&elements, max, &method](auto& it)
+    //method is the order of min_element: the element which is the smallest according to method is the worst one,
+    //a heap of max elements keeps the best ones in O(nlog(max)) and with exact = false it keeps the ties of the last one in the same pass
+    std::vector<Dictionary<std::string, int, ThreeWayCompare<>>::iterator> best = topK(d, std::size_t(max), exact,
+        [&method](const Dictionary<std::string, int, ThreeWayCompare<>>::iterator& a, const Dictionary<std::string, int, ThreeWayCompare<>>::iterator& b)->bool
         {
-            elements.push_back(it);
-            if ((int)elements.size() > max) {
-                //I am using a little trick here because we can specify the compering
-                //method so min_element can find minimal and maximal element. 
-                elements.remove(*std::min_element(elements.begin(), elements.end(), method));
-            }
-        }
-    );
-    //the problem with exact = false is that we do need to recalculate everything after the insertion of the elements
-    //so after the insertion lest re-insert the remaining elements
-    if (!exact and (int)elements.size() > max) {
-        auto& min = *std::min_element(elements.begin(), elements.end(), method);
-        d.executeForAllNodes([&elements, &min](auto& it)
-            {
-                if (it.getKey() != min.getKey() and it.getInfo() == min.getInfo()) {
-                    elements.push_back(it);
-                }
-            }
-        );
-    }
+            return method(b, a);
+        }, threads);
+    elements.assign(best.begin(), best.end());
     return true;
 }
-void printMaxFrequency(const Dictionary<std::string, int>& d, int max, bool exact) {
+void printMaxFrequency(const Dictionary<std::string, int, ThreeWayCompare<>>& d, int max, bool exact) {
     //list of elements where we are going to pass our results.
-    std::list<Dictionary<std::string, int>::iterator> results;
+    std::list<Dictionary<std::string, int, ThreeWayCompare<>>::iterator> results;
     //the only step is to use getFrequency method.
     if (!getFrequency(d, results, max, exact,
-        [](Dictionary<std::string, int>::iterator& a, Dictionary<std::string, int>::iterator& b)->bool
+        [](const Dictionary<std::string, int, ThreeWayCompare<>>::iterator& a, const Dictionary<std::string, int, ThreeWayCompare<>>::iterator& b)->bool
         {
             return a.getInfo() < b.getInfo();
         }
@@ -93,7 +179,7 @@ void printMaxFrequency(const Dictionary<std::string, int>& d, int max, bool exac
     //task does not really specify if the elements do need to be sorted.
     //in the example they are thats why I am going to do it
     //the sorting is done in line 91-94 so if it's not needed just delete the lines
-    results.sort([](Dictionary<std::string, int>::iterator const & a, Dictionary<std::string, int>::iterator const& b)->bool
+    results.sort([](Dictionary<std::string, int, ThreeWayCompare<>>::iterator const & a, Dictionary<std::string, int, ThreeWayCompare<>>::iterator const& b)->bool
         {
             return a.getInfo() > b.getInfo();
         });
@@ -101,17 +187,17 @@ void printMaxFrequency(const Dictionary<std::string, int>& d, int max, bool exac
         std::cout << it << std::endl;
     }
 }
-void printMinFrequency(const Dictionary<std::string, int>& d, int max, bool exact) {
+void printMinFrequency(const Dictionary<std::string, int, ThreeWayCompare<>>& d, int max, bool exact) {
     //list of elements where we are going to pass our results.
-    std::list<Dictionary<std::string, int>::iterator> results;
+    std::list<Dictionary<std::string, int, ThreeWayCompare<>>::iterator> results;
     getFrequency(d, results, max, exact,
-        [](const Dictionary<std::string, int>::iterator a, const Dictionary<std::string, int>::iterator b)->bool
+        [](const Dictionary<std::string, int, ThreeWayCompare<>>::iterator a, const Dictionary<std::string, int, ThreeWayCompare<>>::iterator b)->bool
         {
             //that's the trick that I have been mentioning.
             return a.getInfo() > b.getInfo();
         }
     );
-    results.sort([](Dictionary<std::string, int>::iterator const& a, Dictionary<std::string, int>::iterator const& b)->bool
+    results.sort([](Dictionary<std::string, int, ThreeWayCompare<>>::iterator const& a, Dictionary<std::string, int, ThreeWayCompare<>>::iterator const& b)->bool
         {
             return a.getInfo() < b.getInfo();
         });
@@ -119,6 +205,21 @@ void printMinFrequency(const Dictionary<std::string, int>& d, int max, bool exac
         std::cout << it << std::endl;
     }
 }
+//same as the versions for a Dictionary, the counts are taken from the index so the dictionary is not scanned
+void printMaxFrequency(const FrequencyDictionary<std::string, int, ThreeWayCompare<>>& d, int max, bool exact) {
+    if (max < 0)
+        throw "Incorrect parameters!";
+    for (auto& element : d.top(std::size_t(max), exact)) {
+        std::cout << "Key: " << element.first << ", info: " << element.second << std::endl;
+    }
+}
+void printMinFrequency(const FrequencyDictionary<std::string, int, ThreeWayCompare<>>& d, int max, bool exact) {
+    if (max < 0)
+        throw "Incorrect parameters!";
+    for (auto& element : d.bottom(std::size_t(max), exact)) {
+        std::cout << "Key: " << element.first << ", info: " << element.second << std::endl;
+    }
+}
 void AVLRotations() {
     //according the the task we are supposed to create a graphical representation of the tree
     //for that I am using some additional libs SFML & MEP(this one is developed by me)
@@ -359,73 +460,1586 @@ bool basicFunctionalities() {
         std::cout << "output: false" << std::endl;
         return false;
     }
+    std::cout << "7." << std::endl;
+    std::cout << "try_emplace does not overwrite, insert_or_assign does" << std::endl;
+    std::cout << "!x.try_emplace(11, 5).second and x.find(11).getInfo() == 1 and !x.insert_or_assign(11, 5).second and x.find(11).getInfo() == 5" << std::endl;
+    std::cout << "expected: true" << std::endl;
+    if (!x.try_emplace(11, 5).second and x.find(11).getInfo() == 1 and !x.insert_or_assign(11, 5).second and x.find(11).getInfo() == 5) {
+        std::cout << "output: true" << std::endl;
+    }
+    else {
+        std::cout << "output: false" << std::endl;
+        return false;
+    }
+    std::cout << "8." << std::endl;
+    std::cout << "upsert on a new and on an existing element" << std::endl;
+    std::cout << "x.upsert(14, ++).second and !x.upsert(14, ++).second and x.find(14).getInfo() == 2 and !x.remove(15)" << std::endl;
+    std::cout << "expected: true" << std::endl;
+    auto increment = [](int& info) { ++info; };
+    if (x.upsert(14, increment).second and !x.upsert(14, increment).second and x.find(14).getInfo() == 2 and !x.remove(15)) {
+        std::cout << "output: true" << std::endl;
+    }
+    else {
+        std::cout << "output: false" << std::endl;
+        return false;
+    }
     return true;
 }
-bool readFileTest()
-{
-    //the read file is going to be tested on my very own testbench files
-    //obviously we can use some larger files books etc. but the most important thing here is to prove
-    //the correctness of the algorithm and thats why:
-    //I go have three file which have the same amount of the "words" where the word is:
-    //according to the instruction
-    //a set of characters containing large and small letters <a,..., z> and <A,..., Z>
-    //a large letters are taken into account when compering them so Cat != cat.
-    std::cout << "1. File: first_testbench.txt" << std::endl;
-    //first testbench is showing a simple file containing words seperated with spaces
-    Dictionary<std::string, int> a = readFile("first_testbench.txt");
-    a.preorder();
-    std::cout << std::endl;
-    std::cout << "Warning! The order of preorder is different bacause of a different order of insertion." << std::endl;
-    std::cout << "2. File: first_testbench_notperfect_mixed.txt" << std::endl;
-    Dictionary<std::string, int> b = readFile("first_testbench_notperfect_mixed.txt");
-    b.preorder();
-    std::cout << std::endl;
-    //this file shows the exact numeration of every word so it's clear to see that the algorithm is working properly
-    std::cout << "3. File: first_testbench_numered.txt" << std::endl;
-    Dictionary<std::string, int> c = readFile("first_testbench_numered.txt");
-    c.preorder();
-    std::cout << std::endl;
-    if (a != c)
+bool orderedLookups() {
+    std::cout << "---ordered lookups." << std::endl;
+    Dictionary<int, int> x;
+    for (int i = 10; i <= 100; i += 10) {
+        x.insert(i, i / 10);
+    }
+    std::cout << "1." << std::endl;
+    std::cout << "x.find(70).getInfo() == 7 and x.find(75).isNull() and x.contains(10) and !x.contains(5)" << std::endl;
+    std::cout << "expected: true" << std::endl;
+    if (x.find(70).getInfo() == 7 and x.find(75).isNull() and x.contains(10) and !x.contains(5)) {
+        std::cout << "output: true" << std::endl;
+    }
+    else {
+        std::cout << "output: false" << std::endl;
+        return false;
+    }
+    std::cout << "2." << std::endl;
+    std::cout << "x.lower_bound(35).getKey() == 40 and x.lower_bound(40).getKey() == 40 and x.lower_bound(101) == x.end()" << std::endl;
+    std::cout << "expected: true" << std::endl;
+    if (x.lower_bound(35).getKey() == 40 and x.lower_bound(40).getKey() == 40 and x.lower_bound(101) == x.end()) {
+        std::cout << "output: true" << std::endl;
+    }
+    else {
+        std::cout << "output: false" << std::endl;
         return false;
+    }
+    std::cout << "3." << std::endl;
+    std::cout << "x.upper_bound(40).getKey() == 50 and x.upper_bound(100) == x.end() and --x.upper_bound(100) == x.find(100)" << std::endl;
+    std::cout << "expected: true" << std::endl;
+    if (x.upper_bound(40).getKey() == 50 and x.upper_bound(100) == x.end() and --x.upper_bound(100) == x.find(100)) {
+        std::cout << "output: true" << std::endl;
+    }
+    else {
+        std::cout << "output: false" << std::endl;
+        return false;
+    }
+    std::cout << "4." << std::endl;
+    std::cout << "equal_range(50) contains exactly one element, equal_range(55) is empty" << std::endl;
+    std::cout << "expected: true" << std::endl;
+    auto found = x.equal_range(50);
+    auto missing = x.equal_range(55);
+    if (found.first.getKey() == 50 and ++found.first == found.second and missing.first == missing.second) {
+        std::cout << "output: true" << std::endl;
+    }
+    else {
+        std::cout << "output: false" << std::endl;
+        return false;
+    }
     return true;
 }
-bool frequencyTest() 
-{
-    //the frequency testing is starting from an example from the lecture
-    Dictionary<std::string, int> d;
-    d.insert("Warsaw", 33);
-    d.insert("Cracow", 20);
-    d.insert("Gdansk", 10);
-    d.insert("Szczecin", 10);
-    std::cout << "max = 3, exact = true" << std::endl;
-    printMaxFrequency(d, 3, true);
-    std::cout << "max = 3, exact = false" << std::endl;
-    printMaxFrequency(d, 3, false);
-    //not enaught elements case
-    std::cout << "max = 5, exact = false" << std::endl;
-    printMaxFrequency(d, 5, false);
-    //negative max
-    std::cout << "max = -5, exact = false" << std::endl;
+bool orderStatistics() {
+    std::cout << "---order statistics." << std::endl;
+    Dictionary<int, int> x;
+    for (int i = 1; i <= 99; i++) {
+        x.insert(i * 10, i);
+    }
+    x.remove(500);
+    std::cout << "1." << std::endl;
+    std::cout << "x.size() == 98 and x.select(0).getKey() == 10 and x.select(97).getKey() == 990 and x.select(98) == x.end()" << std::endl;
+    std::cout << "expected: true" << std::endl;
+    if (x.size() == 98 and x.select(0).getKey() == 10 and x.select(97).getKey() == 990 and x.select(98) == x.end()) {
+        std::cout << "output: true" << std::endl;
+    }
+    else {
+        std::cout << "output: false" << std::endl;
+        return false;
+    }
+    std::cout << "2." << std::endl;
+    std::cout << "median and rank: x.select(49).getKey() == 510 and x.rank(510) == 49 and x.rank(505) == 49" << std::endl;
+    std::cout << "expected: true" << std::endl;
+    if (x.select(49).getKey() == 510 and x.rank(510) == 49 and x.rank(505) == 49) {
+        std::cout << "output: true" << std::endl;
+    }
+    else {
+        std::cout << "output: false" << std::endl;
+        return false;
+    }
+    std::cout << "3." << std::endl;
+    std::cout << "x.count_range(100, 600) == 50 and x.count_range(95, 105) == 1 and x.count_range(600, 100) == 0" << std::endl;
+    std::cout << "expected: true" << std::endl;
+    if (x.count_range(100, 600) == 50 and x.count_range(95, 105) == 1 and x.count_range(600, 100) == 0) {
+        std::cout << "output: true" << std::endl;
+    }
+    else {
+        std::cout << "output: false" << std::endl;
+        return false;
+    }
+    std::cout << "4." << std::endl;
+    std::cout << "descending order, the bounds follow the comparator: y.count_range(8, 3) == 6 and y.count_range(3, 8) == 0 and y.select(0).getKey() == 10 and y.rank(3) == 7" << std::endl;
+    std::cout << "expected: true" << std::endl;
+    Dictionary<int, int, std::greater<int>> y;
+    for (int i = 1; i <= 10; i++) {
+        y.insert(i, i);
+    }
+    if (y.count_range(8, 3) == 6 and y.count_range(3, 8) == 0 and y.select(0).getKey() == 10 and y.rank(3) == 7) {
+        std::cout << "output: true" << std::endl;
+    }
+    else {
+        std::cout << "output: false" << std::endl;
+        return false;
+    }
+    return true;
+}
+bool bulkLoad() {
+    std::cout << "---bulk load." << std::endl;
+    std::cout << "1." << std::endl;
+    std::cout << "building from 1000 sorted elements, the tree is perfectly balanced" << std::endl;
+    std::cout << "x.size() == 1000 and x.getHeight() == 10 and x.find(500).getInfo() == 250" << std::endl;
+    std::cout << "expected: true" << std::endl;
+    std::list<std::pair<int, int>> sorted;
+    for (int i = 0; i < 1000; i++) {
+        sorted.push_back(std::make_pair(2 * i, i));
+    }
+    Dictionary<int, int> x(sorted.begin(), sorted.end());
+    if (x.size() == 1000 and x.getHeight() == 10 and x.find(500).getInfo() == 250) {
+        std::cout << "output: true" << std::endl;
+    }
+    else {
+        std::cout << "output: false" << std::endl;
+        return false;
+    }
+    std::cout << "2." << std::endl;
+    std::cout << "unsorted input with duplicates, infos are summed" << std::endl;
+    std::cout << "y.size() == 3 and y.find(\"cat\").getInfo() == 3 and y.begin().getKey() == \"ant\"" << std::endl;
+    std::cout << "expected: true" << std::endl;
+    std::list<std::pair<std::string, int>> words = { {"cat", 1}, {"dog", 1}, {"cat", 1}, {"ant", 1}, {"cat", 1} };
+    Dictionary<std::string, int> y;
+    y.assign(words.begin(), words.end(), [](int& a, int b) { a += b; });
+    if (y.size() == 3 and y.find("cat").getInfo() == 3 and y.begin().getKey() == "ant") {
+        std::cout << "output: true" << std::endl;
+    }
+    else {
+        std::cout << "output: false" << std::endl;
+        return false;
+    }
+    std::cout << "3." << std::endl;
+    std::cout << "unsorted input without a combiner" << std::endl;
+    std::cout << "expected: Range is not sorted!" << std::endl;
     try {
-        printMaxFrequency(d, -5, false);
+        y.assign(words.begin(), words.end());
+        std::cout << "output: false" << std::endl;
+        return false;
     }
     catch (const char* err) {
-        std::cout << err;
+        std::cout << "output: " << err << std::endl;
+    }
+    std::cout << "4." << std::endl;
+    std::cout << "assign to a non-empty dictionary using a pool, the new nodes come from the same pool as the old ones" << std::endl;
+    std::cout << "z.size() == 1000 and z.find(500).getInfo() == 250 and !z.contains(1)" << std::endl;
+    std::cout << "expected: true" << std::endl;
+    Dictionary<int, int, std::less<int>, PoolAllocator<std::pair<const int, int>>> z;
+    z.insert(1, 1);
+    z.assign(sorted.begin(), sorted.end());
+    if (z.size() == 1000 and z.find(500).getInfo() == 250 and !z.contains(1)) {
+        std::cout << "output: true" << std::endl;
+    }
+    else {
+        std::cout << "output: false" << std::endl;
+        return false;
+    }
+    return y.size() == 3;
+}
+bool setAlgebra() {
+    std::cout << "---set algebra." << std::endl;
+    Dictionary<std::string, int> first, second;
+    first.insert("ant", 1); first.insert("bee", 2); first.insert("cat", 3);
+    second.insert("bee", 10); second.insert("cat", 20); second.insert("dog", 30);
+    auto add = [](int& mine, int theirs) { mine += theirs; };
+    std::cout << "1." << std::endl;
+    std::cout << "union_with, counts of the same words are summed" << std::endl;
+    std::cout << "expected keys: ant 1, bee 12, cat 23, dog 30" << std::endl;
+    Dictionary<std::string, int> x(first);
+    x.union_with(second, add);
+    x.inorder();
+    if (x.size() != 4 or x.find("bee").getInfo() != 12 or x.find("dog").getInfo() != 30 or second.size() != 3) {
+        return false;
+    }
+    std::cout << "2." << std::endl;
+    std::cout << "intersection" << std::endl;
+    std::cout << "expected keys: bee 2, cat 3" << std::endl;
+    x = first;
+    x.intersection(second);
+    x.inorder();
+    if (x.size() != 2 or x.find("bee").getInfo() != 2) {
+        return false;
+    }
+    std::cout << "3." << std::endl;
+    std::cout << "difference" << std::endl;
+    std::cout << "expected keys: ant 1" << std::endl;
+    x = first;
+    x.difference(second);
+    x.inorder();
+    if (x.size() != 1 or !x.contains("ant")) {
+        return false;
+    }
+    std::cout << "4." << std::endl;
+    std::cout << "merge_with takes over the nodes, other is left empty" << std::endl;
+    std::cout << "expected keys: ant 1, bee 12, cat 23, dog 30" << std::endl;
+    x = first;
+    x.merge_with(second, add);
+    x.inorder();
+    if (x.size() != 4 or x.find("cat").getInfo() != 23 or !second.empty()) {
+        return false;
     }
-    
     return true;
 }
-int main()
-{
-    std::cout << "\n\n AVLRotations() \n\n";
-    AVLRotations();
-    std::cout << "\n\n basicFunctionalities() \n\n";
-    if (!basicFunctionalities()) {
-        std::cout << "error";
-        return 0;
+Dictionary<std::string, int> makeWords() {
+    Dictionary<std::string, int> words;
+    words.insert("a rather long word that does not fit into the small string buffer", 1);
+    words.insert("another rather long word that does not fit into the small string buffer", 2);
+    words.insert("yet another rather long word that does not fit into the small string buffer", 3);
+    return words;
+}
+//two named candidates, so the return cannot be elided (NRVO) and the result is move constructed
+Dictionary<std::string, int> takeWords(Dictionary<std::string, int>& words, bool keep) {
+    Dictionary<std::string, int> taken(std::move(words)), none;
+    if (keep) {
+        return taken;
     }
-    std::cout << "\n\n iterators() \n\n";
-    if (!iterators()) {
+    return none;
+}
+bool moveSemantics() {
+    std::cout << "---move semantics." << std::endl;
+    std::cout << "1." << std::endl;
+    std::cout << "move construction, move assignment and returning by value do not allocate" << std::endl;
+    std::cout << "expected: 0 allocations" << std::endl;
+    Dictionary<std::string, int> words = makeWords();
+    unsigned long long before = allocations;
+    Dictionary<std::string, int> moved(std::move(words));
+    words = std::move(moved);
+    Dictionary<std::string, int> returned = takeWords(words, true);
+    words = std::move(returned);
+    std::cout << "output: " << allocations - before << " allocations" << std::endl;
+    if (allocations != before or !moved.empty() or !returned.empty() or words.find("another rather long word that does not fit into the small string buffer").getInfo() != 2) {
+        return false;
+    }
+    std::cout << "2." << std::endl;
+    std::cout << "extract and insert of a node to another dictionary do not allocate" << std::endl;
+    std::cout << "expected: 0 allocations" << std::endl;
+    Dictionary<std::string, int> other;
+    std::string key = "a rather long word that does not fit into the small string buffer";
+    before = allocations;
+    auto node = words.extract(key);
+    bool inserted = other.insert(std::move(node)).second;
+    std::cout << "output: " << allocations - before << " allocations" << std::endl;
+    if (allocations != before or !inserted or !node.empty() or words.contains(key) or other.begin().getInfo() != 1) {
+        return false;
+    }
+    std::cout << "3." << std::endl;
+    std::cout << "emplace builds the key in place, so it allocates only the node and the key" << std::endl;
+    std::cout << "expected: 2 allocations" << std::endl;
+    before = allocations;
+    other.emplace("one more rather long word that does not fit into the small string buffer", 4);
+    std::cout << "output: " << allocations - before << " allocations" << std::endl;
+    if (allocations - before != 2) {
+        return false;
+    }
+    return true;
+}
+bool poolAllocation() {
+    std::cout << "---pool allocator." << std::endl;
+    typedef Dictionary<int, int, std::less<int>, PoolAllocator<std::pair<const int, int>>> Pooled;
+    std::cout << "1." << std::endl;
+    std::cout << "after reserve(1000) inserting 1000 elements, removing half of them and inserting them again does not allocate" << std::endl;
+    std::cout << "expected: 0 allocations" << std::endl;
+    Pooled x;
+    x.reserve(1000);
+    unsigned long long before = allocations;
+    for (int i = 0; i < 1000; i++) {
+        x.insert((i * 37) % 1000, i);
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        x.remove(i);
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        x.insert(i, -i);
+    }
+    std::cout << "output: " << allocations - before << " allocations" << std::endl;
+    if (allocations != before or x.size() != 1000 or x.find(500).getInfo() != -500 or x.find(37).getInfo() != 1) {
+        return false;
+    }
+    std::cout << "2." << std::endl;
+    std::cout << "a copy gets its own pool, clearing it leaves the original untouched" << std::endl;
+    std::cout << "expected: true" << std::endl;
+    Pooled copy(x);
+    bool equal = copy == x;
+    copy.clear();
+    copy.insert(1, 1);
+    if (equal and copy.size() == 1 and x.size() == 1000 and x.find(999).getInfo() == 27) {
+        std::cout << "output: true" << std::endl;
+    }
+    else {
+        std::cout << "output: false" << std::endl;
+        return false;
+    }
+    std::cout << "3." << std::endl;
+    std::cout << "moving does not allocate, the moved from dictionary can still be used" << std::endl;
+    std::cout << "expected: 0 allocations" << std::endl;
+    before = allocations;
+    Pooled moved(std::move(x));
+    x = std::move(moved);
+    moved = std::move(copy);
+    std::cout << "output: " << allocations - before << " allocations" << std::endl;
+    if (allocations != before or x.size() != 1000 or !copy.empty() or moved.size() != 1) {
+        return false;
+    }
+    copy.insert(2, 2);
+    if (copy.size() != 1 or copy.find(2).getInfo() != 2) {
+        return false;
+    }
+    std::cout << "4." << std::endl;
+    std::cout << "clear() gives back the chunks at once, the next insert allocates a new chunk" << std::endl;
+    std::cout << "expected: 1 allocation" << std::endl;
+    x.clear();
+    before = allocations;
+    x.insert(1, 1);
+    std::cout << "output: " << allocations - before << " allocation" << std::endl;
+    if (allocations - before != 1 or x.size() != 1) {
+        return false;
+    }
+    std::cout << "5." << std::endl;
+    std::cout << "a moved from dictionary does not share the pool, so both of them can give back their chunks at once" << std::endl;
+    std::cout << "expected: 2 allocations" << std::endl;
+    Pooled source;
+    for (int i = 0; i < 100; i++) {
+        source.insert(i, i);
+    }
+    Pooled target(std::move(source));
+    source.insert(1, 1);
+    target.clear();
+    source.clear();
+    before = allocations;
+    target.insert(1, 1);
+    source.insert(1, 1);
+    std::cout << "output: " << allocations - before << " allocations" << std::endl;
+    if (allocations - before != 2 or target.size() != 1 or source.size() != 1) {
+        return false;
+    }
+    std::cout << "6." << std::endl;
+    std::cout << "extract and insert between dictionaries sharing a pool do not allocate, the node is taken over" << std::endl;
+    std::cout << "expected: 0 allocations" << std::endl;
+    typedef Dictionary<std::string, int, std::less<std::string>, PoolAllocator<std::pair<const std::string, int>>> Words;
+    std::string key = "a rather long word that does not fit into the small string buffer";
+    PoolAllocator<std::pair<const std::string, int>> pool;
+    Words first(pool), second(pool);
+    first.insert(key, 1);
+    first.insert("ant", 2);
+    before = allocations;
+    auto node = first.extract(key);
+    bool inserted = second.insert(std::move(node)).second;
+    std::cout << "output: " << allocations - before << " allocations" << std::endl;
+    if (allocations != before or !inserted or !node.empty() or first.contains(key) or second.find(key).getInfo() != 1) {
+        return false;
+    }
+    std::cout << "7." << std::endl;
+    std::cout << "a node coming from a different pool is moved into a node of the own pool, the key is not copied" << std::endl;
+    std::cout << "expected: 0 allocations" << std::endl;
+    Words third;
+    third.reserve(1);
+    before = allocations;
+    node = second.extract(key);
+    inserted = third.insert(std::move(node)).second;
+    std::cout << "output: " << allocations - before << " allocations" << std::endl;
+    if (allocations != before or !inserted or !node.empty() or !second.empty() or third.find(key).getInfo() != 1) {
+        return false;
+    }
+    third.remove(key);
+    std::cout << "8." << std::endl;
+    std::cout << "reserve of more blocks than fit in the memory throws std::bad_alloc instead of a too small chunk" << std::endl;
+    std::cout << "expected: true" << std::endl;
+    bool thrown = false;
+    try {
+        third.reserve(std::numeric_limits<std::size_t>::max() / 2);
+    }
+    catch (const std::bad_alloc&) {
+        thrown = true;
+    }
+    std::cout << "output: " << (thrown ? "true" : "false") << std::endl;
+    return thrown and first.size() == 1 and third.empty();
+}
+bool compactLayout() {
+    std::cout << "---compact layout." << std::endl;
+    std::cout << "1." << std::endl;
+    std::cout << "the same elements and shape as Dictionary after inserting and removing" << std::endl;
+    Dictionary<int, int> d;
+    CompactDictionary<int, int> c;
+    for (int i = 0; i < 1000; i++) {
+        d.insert((i * 37) % 1000, i);
+        c.insert((i * 37) % 1000, i);
+    }
+    for (int i = 0; i < 1000; i += 3) {
+        d.remove(i);
+        c.remove(i);
+    }
+    std::cout << "expected: " << d.size() << " elements, height " << d.getHeight() << std::endl;
+    std::cout << "output: " << c.size() << " elements, height " << c.getHeight() << std::endl;
+    if (c.size() != d.size() or c.getHeight() != d.getHeight()) {
+        return false;
+    }
+    Dictionary<int, int>::iterator a = d.begin();
+    for (CompactDictionary<int, int>::iterator b = c.begin(); b != c.end(); ++b, ++a) {
+        if (b.getKey() != a.getKey() or b.getInfo() != a.getInfo()) {
+            return false;
+        }
+    }
+    std::cout << "2." << std::endl;
+    std::cout << "reverse iteration, lower_bound and upsert" << std::endl;
+    std::cout << "expected: Key: 998, info: 54 Key: 4, info: 892 Key: 5, info: 66" << std::endl;
+    c.upsert(5, [](int& info) { info = 66; });
+    std::cout << "output: " << c.rbegin() << " " << c.lower_bound(3) << " " << c.find(5) << std::endl;
+    if (c.rbegin().getKey() != 998 or c.lower_bound(3).getKey() != 4 or c.find(5).getInfo() != 66 or c.contains(3)) {
+        return false;
+    }
+    return true;
+}
+bool frozenLookups() {
+    std::cout << "---frozen dictionary." << std::endl;
+    Dictionary<int, int> d;
+    for (int i = 0; i < 100; i++) {
+        d.insert(i * 2, i);
+    }
+    FrozenDictionary<int, int> f = d.freeze();
+    std::cout << "1." << std::endl;
+    std::cout << "in order iteration gives the same elements as the tree" << std::endl;
+    std::cout << "expected: " << d.size() << " elements" << std::endl;
+    std::size_t count = 0;
+    Dictionary<int, int>::iterator a = d.begin();
+    for (FrozenDictionary<int, int>::iterator b = f.begin(); b != f.end(); ++b, ++a, ++count) {
+        if (b.getKey() != a.getKey() or b.getInfo() != a.getInfo()) {
+            return false;
+        }
+    }
+    std::cout << "output: " << count << " elements" << std::endl;
+    if (count != d.size()) {
+        return false;
+    }
+    std::cout << "2." << std::endl;
+    std::cout << "find and lower_bound" << std::endl;
+    std::cout << "expected: Key: 42, info: 21 Key:  - , info:  -  Key: 44, info: 22 Key:  - , info:  - " << std::endl;
+    std::cout << "output: " << f.find(42) << " " << f.find(43) << " " << f.lower_bound(43) << " " << f.lower_bound(199) << std::endl;
+    if (f.find(42).getInfo() != 21 or !f.find(43).isNull() or f.lower_bound(43).getKey() != 44 or !f.lower_bound(199).isNull()) {
+        return false;
+    }
+    return true;
+}
+bool bplusStorage() {
+    std::cout << "---B+ tree storage." << std::endl;
+    std::cout << "1." << std::endl;
+    std::cout << "the same elements as the AVL tree after inserting and removing" << std::endl;
+    Dictionary<int, int> d;
+    BPlusDictionary<int, int, 8> b;
+    for (int i = 0; i < 1000; i++) {
+        d.insert((i * 37) % 1000, i);
+        b.insert((i * 37) % 1000, i);
+    }
+    for (int i = 0; i < 1000; i += 3) {
+        d.remove(i);
+        b.remove(i);
+    }
+    std::cout << "expected: " << d.size() << " elements, 4 levels" << std::endl;
+    std::cout << "output: " << b.size() << " elements, " << b.getHeight() << " levels" << std::endl;
+    if (b.size() != d.size() or b.getHeight() != 4) {
+        return false;
+    }
+    Dictionary<int, int>::iterator a = d.begin();
+    for (BPlusDictionary<int, int, 8>::iterator it = b.begin(); it != b.end(); ++it, ++a) {
+        if (it.getKey() != a.getKey() or it.getInfo() != a.getInfo()) {
+            return false;
+        }
+    }
+    std::cout << "2." << std::endl;
+    std::cout << "reverse iteration, lower_bound and upsert" << std::endl;
+    std::cout << "expected: Key: 998, info: 54 Key: 4, info: 892 Key: 5, info: 66" << std::endl;
+    b.upsert(5, [](int& info) { info = 66; });
+    std::cout << "output: " << b.rbegin() << " " << b.lower_bound(3) << " " << b.find(5) << std::endl;
+    if (b.rbegin().getKey() != 998 or b.lower_bound(3).getKey() != 4 or b.find(5).getInfo() != 66 or b.contains(3)) {
+        return false;
+    }
+    return true;
+}
+bool transparentLookups() {
+    std::cout << "---transparent lookups." << std::endl;
+    Dictionary<std::string, int, std::less<>> words;
+    std::string text = "a rather long word that does not fit into the small string buffer";
+    words.insert(text, 1);
+    std::string_view word(text);
+    std::cout << "1." << std::endl;
+    std::cout << "find, contains, lower_bound and upsert of an existing word with std::string_view do not allocate" << std::endl;
+    std::cout << "expected: 0 allocations, count 2" << std::endl;
+    unsigned long long before = allocations;
+    bool found = !words.find(word).isNull() and words.contains(word) and words.lower_bound(word).getInfo() == 1;
+    words.upsert(word, [](int& count) { ++count; });
+    std::cout << "output: " << allocations - before << " allocations, count " << words.find(word).getInfo() << std::endl;
+    if (allocations != before or !found or words.find(text).getInfo() != 2) {
+        return false;
+    }
+    std::cout << "2." << std::endl;
+    std::cout << "upsert of a new word builds the key, so it allocates only the node and the key" << std::endl;
+    std::cout << "expected: 2 allocations" << std::endl;
+    before = allocations;
+    words.upsert(word.substr(2), [](int& count) { ++count; });
+    std::cout << "output: " << allocations - before << " allocations" << std::endl;
+    if (allocations - before != 2 or words.size() != 2 or words.find(word.substr(2)).getInfo() != 1) {
+        return false;
+    }
+    return true;
+}
+//number of key comparisons made by the comparators below
+static unsigned long long comparisons = 0;
+struct CountingLess {
+    bool operator()(const std::string& a, const std::string& b) const {
+        ++comparisons;
+        return a < b;
+    }
+};
+struct CountingThreeWay : CountingLess {
+    int compare(const std::string& a, const std::string& b) const {
+        ++comparisons;
+        return a.compare(b);
+    }
+};
+template<typename Compare>
+unsigned long long countFind(const Dictionary<std::string, int, Compare>& d, const std::string& key) {
+    unsigned long long before = comparisons;
+    d.find(key);
+    return comparisons - before;
+}
+template<typename Compare>
+unsigned long long countWords(int count) {
+    unsigned long long before = comparisons;
+    Dictionary<std::string, int, Compare> d;
+    //the same pseudo random order for both comparators
+    for (int i = 0; i < count; ++i) {
+        d.insert("word" + std::to_string(i * 7919 % count), i);
+    }
+    for (int i = 0; i < count; ++i) {
+        d.find("word" + std::to_string(i));
+    }
+    for (int i = 0; i < count; ++i) {
+        d.remove("word" + std::to_string(i * 31 % count));
+    }
+    return comparisons - before;
+}
+bool threeWayComparisons() {
+    std::cout << "---three-way comparisons." << std::endl;
+    Dictionary<std::string, int, CountingLess> less;
+    Dictionary<std::string, int, CountingThreeWay> threeWay;
+    for (int i = 1; i <= 7; ++i) {
+        less.insert(std::to_string(i), i);
+        threeWay.insert(std::to_string(i), i);
+    }
+    std::cout << "1." << std::endl;
+    std::cout << "find of the head 4, of 1 (two times left) and of 7 (two times right) in a perfect tree of 1...7" << std::endl;
+    std::cout << "expected: less 2 4 6, three-way 1 3 3" << std::endl;
+    unsigned long long l4 = countFind(less, "4"), l1 = countFind(less, "1"), l7 = countFind(less, "7");
+    unsigned long long t4 = countFind(threeWay, "4"), t1 = countFind(threeWay, "1"), t7 = countFind(threeWay, "7");
+    std::cout << "output: less " << l4 << " " << l1 << " " << l7 << ", three-way " << t4 << " " << t1 << " " << t7 << std::endl;
+    if (l4 != 2 or l1 != 4 or l7 != 6 or t4 != 1 or t1 != 3 or t7 != 3) {
+        return false;
+    }
+    std::cout << "2." << std::endl;
+    std::cout << "insert, find and remove of 1000 words, three-way compares once per node on the path" << std::endl;
+    unsigned long long lessTotal = countWords<CountingLess>(1000);
+    unsigned long long threeWayTotal = countWords<CountingThreeWay>(1000);
+    std::cout << "output: less " << lessTotal << ", three-way " << threeWayTotal << std::endl;
+    if (threeWayTotal >= lessTotal) {
+        return false;
+    }
+    return true;
+}
+bool concurrentAccess() {
+    std::cout << "---concurrent access." << std::endl;
+    ConcurrentDictionary<int, int> d;
+    std::cout << "1." << std::endl;
+    std::cout << "4 threads insert 10000 keys each and remove the odd ones, 2 threads look the keys up meanwhile" << std::endl;
+    std::cout << "expected: size 20000, only even keys, 0 wrong infos" << std::endl;
+    std::atomic<bool> done(false);
+    std::atomic<int> wrong(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&d, t]() {
+            for (int key = t; key < 40000; key += 4) {
+                d.insert(key, key);
+            }
+            for (int key = t; key < 40000; key += 4) {
+                if (key % 2) {
+                    d.remove(key);
+                }
+            }
+        });
+    }
+    for (int t = 0; t < 2; ++t) {
+        threads.emplace_back([&d, &done, &wrong]() {
+            while (!done) {
+                for (int key = 0; key < 40000; key += 7) {
+                    int info = -1;
+                    if (d.find(key, info) and info != key) {
+                        ++wrong;
+                    }
+                }
+            }
+        });
+    }
+    for (int t = 0; t < 4; ++t) {
+        threads[t].join();
+    }
+    done = true;
+    threads[4].join();
+    threads[5].join();
+    Dictionary<int, int> result = d.toDictionary();
+    bool even = true;
+    for (auto it = result.begin(); it != result.end(); ++it) {
+        even = even and it.getKey() % 2 == 0 and it.getInfo() == it.getKey();
+    }
+    std::cout << "output: size " << d.size() << (even ? ", only even keys, " : ", odd keys, ") << wrong << " wrong infos" << std::endl;
+    if (d.size() != 20000 or result.size() != 20000 or !even or wrong != 0) {
+        return false;
+    }
+    std::cout << "2." << std::endl;
+    std::cout << "4 threads count 10 words 1000 times each with upsert" << std::endl;
+    std::cout << "expected: 10 words, every count 400" << std::endl;
+    ConcurrentDictionary<std::string, int, ThreeWayCompare<>> words;
+    threads.clear();
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&words]() {
+            for (int i = 0; i < 1000; ++i) {
+                words.upsert("word" + std::to_string(i % 10), [](int& count) { ++count; });
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    Dictionary<std::string, int, ThreeWayCompare<>> counts = words.toDictionary();
+    bool all = counts.size() == 10;
+    for (auto it = counts.begin(); it != counts.end(); ++it) {
+        all = all and it.getInfo() == 400;
+    }
+    std::cout << "output: " << counts.size() << " words, " << (all ? "every count 400" : "wrong counts") << std::endl;
+    return all;
+}
+bool persistentSnapshots() {
+    std::cout << "---persistent snapshots." << std::endl;
+    PersistentDictionary<int, int> d;
+    //1023 increasing keys make a perfect tree of height 10
+    for (int i = 0; i < 1023; ++i) {
+        d.insert(i, i);
+    }
+    std::cout << "1." << std::endl;
+    std::cout << "snapshot() is O(1), an insertion copies only the path of 10 nodes which are shared with a snapshot" << std::endl;
+    std::cout << "expected: snapshot 0 allocations, insert 1 allocation without a snapshot and 11 with one" << std::endl;
+    unsigned long long before = allocations;
+    d.insert(2000, 2000);
+    unsigned long long alone = allocations - before;
+    d.remove(2000);
+    before = allocations;
+    PersistentDictionary<int, int>::Snapshot s = d.snapshot();
+    unsigned long long snapshot = allocations - before;
+    before = allocations;
+    d.insert(2000, 2000);
+    unsigned long long shared = allocations - before;
+    std::cout << "output: snapshot " << snapshot << " allocations, insert " << alone << " allocation without a snapshot and " << shared << " with one" << std::endl;
+    if (snapshot != 0 or alone != 1 or shared != 11) {
+        return false;
+    }
+    std::cout << "2." << std::endl;
+    std::cout << "the odd keys are removed and the even ones changed, the snapshot keeps the old version" << std::endl;
+    std::cout << "expected: dictionary 513 elements, snapshot 1023 elements, 2000 only in the dictionary, s.find(2) is 2" << std::endl;
+    for (int i = 0; i < 1023; ++i) {
+        if (i % 2) {
+            d.remove(i);
+        }
+        else {
+            d.insert_or_assign(i, -i);
+        }
+    }
+    int sum = 0;
+    for (auto it = s.begin(); it != s.end(); ++it) {
+        sum += it.getInfo() == it.getKey();
+    }
+    std::cout << "output: dictionary " << d.size() << " elements, snapshot " << sum << " elements, 2000 "
+        << (d.contains(2000) and !s.contains(2000) ? "only in the dictionary" : "wrong") << ", s.find(2) is " << s.find(2).getInfo() << std::endl;
+    if (d.size() != 513 or s.size() != 1023 or sum != 1023 or !d.contains(2000) or s.contains(2000) or s.find(2).getInfo() != 2 or d.find(2).getInfo() != -2) {
+        return false;
+    }
+    return true;
+}
+bool shardedCounting() {
+    std::cout << "---sharded counting." << std::endl;
+    ShardedDictionary<std::string, int, ThreeWayCompare<>> d(4);
+    std::cout << "1." << std::endl;
+    std::cout << "4 threads count 50 words 1000 times each with increment" << std::endl;
+    std::cout << "expected: 4 shards, 50 words, every count 80, merged iteration sorted" << std::endl;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&d]() {
+            for (int i = 0; i < 1000; ++i) {
+                d.increment("word" + std::to_string(i % 50), 1);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    bool all = true, sorted = true;
+    std::string previous;
+    for (auto it = d.begin(); it != d.end(); ++it) {
+        all = all and it.getInfo() == 80;
+        sorted = sorted and previous < it.getKey();
+        previous = it.getKey();
+    }
+    std::cout << "output: " << d.shards() << " shards, " << d.size() << " words, " << (all ? "every count 80" : "wrong counts")
+        << ", merged iteration " << (sorted ? "sorted" : "not sorted") << std::endl;
+    if (d.shards() != 4 or d.size() != 50 or !all or !sorted) {
+        return false;
+    }
+    std::cout << "2." << std::endl;
+    std::cout << "3 threads read the testbench files to one sharded dictionary" << std::endl;
+    std::cout << "expected: the same words and counts as readFile of the three files merged" << std::endl;
+    const char* files[] = { "first_testbench.txt", "first_testbench_notperfect_mixed.txt", "first_testbench_numered.txt" };
+    ShardedDictionary<std::string, int, ThreeWayCompare<>> words;
+    Dictionary<std::string, int, ThreeWayCompare<>> expected;
+    threads.clear();
+    for (const char* name : files) {
+        Dictionary<std::string, int, ThreeWayCompare<>> single = readFile(name);
+        expected.merge_with(single, [](int& count, int&& other) { count += other; });
+        threads.emplace_back([&words, name]() {
+            std::fstream file(name);
+            forEachWord(file, [&words](std::string_view word) { words.increment(word, 1); });
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    //operator== compares the shape of the trees as well, so the elements are compared in order
+    bool same = !expected.empty() and sameElements(expected, words);
+    std::cout << "output: " << (same ? "the same" : "different") << " words and counts (" << words.size() << " words)" << std::endl;
+    return same;
+}
+bool parallelReadFile() {
+    std::cout << "---parallel readFile." << std::endl;
+    std::cout << "1." << std::endl;
+    std::cout << "the testbench files are read with 1, 2, 3, 7 and 64 threads (more threads than words)" << std::endl;
+    std::cout << "expected: the same counts as readFile(filename) for every file and number of threads" << std::endl;
+    const char* files[] = { "first_testbench.txt", "first_testbench_notperfect_mixed.txt", "first_testbench_numered.txt" };
+    bool same = true;
+    for (const char* name : files) {
+        Dictionary<std::string, int, ThreeWayCompare<>> serial = readFile(name);
+        for (unsigned threads : { 1u, 2u, 3u, 7u, 64u }) {
+            same = same and sameElements(serial, readFile(name, threads));
+        }
+    }
+    std::cout << "output: " << (same ? "the same counts" : "different counts") << std::endl;
+    if (!same) {
+        return false;
+    }
+    std::cout << "2." << std::endl;
+    std::cout << "16 MB file with 100000 different words, 1 thread (serial readFile) and 4 threads" << std::endl;
+    std::cout << "expected: the same counts" << std::endl;
+    const char* name = "parallel_benchmark.txt";
+    {
+        std::ofstream out(name, std::ios::binary);
+        std::string text;
+        for (unsigned i = 0; text.size() < (16u << 20); ++i) {
+            for (unsigned word = i * 7919 % 100000 + 1; word; word /= 26) {
+                text += char('a' + word % 26);
+            }
+            text += i % 10 ? ' ' : '\n';
+        }
+        out << text;
+    }
+    auto start = std::chrono::steady_clock::now();
+    Dictionary<std::string, int, ThreeWayCompare<>> serial = readFile(name);
+    double serialTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    Dictionary<std::string, int, ThreeWayCompare<>> parallel = readFile(name, 4);
+    double parallelTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::remove(name);
+    same = serial.size() == 100000 and sameElements(serial, parallel);
+    std::cout << "output: " << (same ? "the same counts" : "different counts") << ", serial " << 16 / serialTime
+        << " MB/s, 4 threads " << 16 / parallelTime << " MB/s (" << std::thread::hardware_concurrency() << " hardware threads)" << std::endl;
+    return same;
+}
+bool mappedReadFile() {
+    std::cout << "---mapped readFile." << std::endl;
+    std::cout << "1." << std::endl;
+    std::cout << "the testbench files are read with readMappedFile" << std::endl;
+    std::cout << "expected: the same counts as readFile(filename)" << std::endl;
+    const char* files[] = { "first_testbench.txt", "first_testbench_notperfect_mixed.txt", "first_testbench_numered.txt" };
+    bool same = true;
+    for (const char* name : files) {
+        same = same and sameElements(readFile(name), readMappedFile(name));
+    }
+    std::cout << "output: " << (same ? "the same counts" : "different counts") << std::endl;
+    if (!same) {
+        return false;
+    }
+    std::cout << "2." << std::endl;
+    std::cout << "16 MB file with words of 1 to 150 letters separated by any byte (@ [ ` { and bytes above 127 as well)" << std::endl;
+    std::cout << "expected: the same counts" << std::endl;
+    const char* name = "mapped_benchmark.txt";
+    {
+        std::ofstream out(name, std::ios::binary);
+        std::string text;
+        std::srand(7);
+        while (text.size() < (16u << 20)) {
+            int length = std::rand() % 10 ? std::rand() % 12 + 1 : std::rand() % 150 + 1;
+            for (int i = 0; i < length; ++i) {
+                text += char((std::rand() % 2 ? 'a' : 'A') + std::rand() % 26);
+            }
+            char separator;
+            do {
+                separator = char(std::rand() % 256);
+            } while (isLetter(separator));
+            text += separator;
+        }
+        //the last word ends at the end of the file
+        text += "end";
+        out << text;
+    }
+    auto start = std::chrono::steady_clock::now();
+    Dictionary<std::string, int, ThreeWayCompare<>> serial = readFile(name);
+    double serialTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    Dictionary<std::string, int, ThreeWayCompare<>> mapped = readMappedFile(name);
+    double mappedTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::size_t words = 0;
+    start = std::chrono::steady_clock::now();
+    {
+        MappedFile file(name);
+        forEachWord(file.view(), [&words](std::string_view) { ++words; });
+    }
+    double scanTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::remove(name);
+    same = sameElements(serial, mapped);
+    std::cout << "output: " << (same ? "the same counts" : "different counts") << ", readFile " << 16 / serialTime
+        << " MB/s, readMappedFile " << 16 / mappedTime << " MB/s, only the scanning (" << words << " words) " << 16 / scanTime << " MB/s" << std::endl;
+    return same;
+}
+bool streamingCounting() {
+    std::cout << "---streaming counting." << std::endl;
+    //4 MB without spaces and new lines, the words are separated with dots, some of them are longer than the buffer
+    std::string text;
+    std::srand(11);
+    while (text.size() < (4u << 20)) {
+        int length = std::rand() % 50 ? std::rand() % 8 + 1 : std::rand() % 3000 + 1;
+        for (int i = 0; i < length; ++i) {
+            text += char('a' + std::rand() % 4);
+        }
+        text += '.';
+    }
+    text += "last";
+    Dictionary<std::string, int, ThreeWayCompare<>> expected;
+    forEachWord(std::string_view(text), [&expected](std::string_view word) {
+        expected.upsert(word, [](int& count) { ++count; });
+    });
+    std::cout << "1." << std::endl;
+    std::cout << "4 MB line read from a stream with a buffer of 1000 bytes, words up to 3000 letters" << std::endl;
+    std::cout << "expected: the same counts as the whole text at once" << std::endl;
+    std::istringstream in(text);
+    WordCounter<Dictionary<std::string, int, ThreeWayCompare<>>> counter(1000);
+    std::vector<std::size_t> sizes;
+    int total = 0, previous = 0;
+    bool growing = true;
+    counter.readAll(in, 1 << 20, [&](const Dictionary<std::string, int, ThreeWayCompare<>>& counts) {
+        sizes.push_back(counts.size());
+        total = 0;
+        counts.executeForAllNodes([&total](Dictionary<std::string, int, ThreeWayCompare<>>::const_iterator& it) { total += it.getInfo(); });
+        growing = growing and total > previous;
+        previous = total;
+    });
+    bool same = sameElements(expected, counter.get());
+    std::cout << "output: " << (same ? "the same counts" : "different counts") << " (" << counter.bytesRead() << " bytes read)" << std::endl;
+    if (!same or counter.bytesRead() != text.size()) {
+        return false;
+    }
+    std::cout << "2." << std::endl;
+    std::cout << "a snapshot of the counts after every 1 MB" << std::endl;
+    std::cout << "expected: 4 snapshots, the number of the counted words grows" << std::endl;
+    std::cout << "output: " << sizes.size() << " snapshots, the number of the counted words " << (growing ? "grows" : "does not grow") << std::endl;
+    return sizes.size() == 4 and growing;
+}
+bool readFileTest()
+{
+    //the read file is going to be tested on my very own testbench files
+    //obviously we can use some larger files books etc. but the most important thing here is to prove
+    //the correctness of the algorithm and thats why:
+    //I go have three file which have the same amount of the "words" where the word is:
+    //according to the instruction
+    //a set of characters containing large and small letters <a,..., z> and <A,..., Z>
+    //a large letters are taken into account when compering them so Cat != cat.
+    std::cout << "1. File: first_testbench.txt" << std::endl;
+    //first testbench is showing a simple file containing words seperated with spaces
+    Dictionary<std::string, int, ThreeWayCompare<>> a = readFile("first_testbench.txt");
+    a.preorder();
+    std::cout << std::endl;
+    std::cout << "Warning! The order of preorder is different bacause of a different order of insertion." << std::endl;
+    std::cout << "2. File: first_testbench_notperfect_mixed.txt" << std::endl;
+    Dictionary<std::string, int, ThreeWayCompare<>> b = readFile("first_testbench_notperfect_mixed.txt");
+    b.preorder();
+    std::cout << std::endl;
+    //this file shows the exact numeration of every word so it's clear to see that the algorithm is working properly
+    std::cout << "3. File: first_testbench_numered.txt" << std::endl;
+    Dictionary<std::string, int, ThreeWayCompare<>> c = readFile("first_testbench_numered.txt");
+    c.preorder();
+    std::cout << std::endl;
+    if (a != c)
+        return false;
+    return true;
+}
+bool topKFrequencies() {
+    std::cout << "---top k frequencies." << std::endl;
+    typedef Dictionary<std::string, int, ThreeWayCompare<>> Counts;
+    auto more = [](const Counts::iterator& a, const Counts::iterator& b) { return a.getInfo() > b.getInfo(); };
+    Counts d;
+    d.insert("a", 5);
+    d.insert("b", 3);
+    d.insert("c", 3);
+    d.insert("d", 3);
+    d.insert("e", 1);
+    std::cout << "1." << std::endl;
+    std::cout << "a 5, b 3, c 3, d 3, e 1, the best 2" << std::endl;
+    std::cout << "expected: exact 2 elements (a 5 and one 3), not exact 4 elements (a 5, b 3, c 3, d 3)" << std::endl;
+    std::vector<Counts::iterator> exact = topK(d, 2, true, more), ties = topK(d, 2, false, more);
+    std::cout << "output: exact " << exact.size() << " elements (" << exact[0].getKey() << " " << exact[0].getInfo() << " and "
+        << exact[1].getInfo() << "), not exact " << ties.size() << " elements" << std::endl;
+    if (exact.size() != 2 or exact[0].getInfo() != 5 or exact[1].getInfo() != 3 or ties.size() != 4 or ties.back().getInfo() != 3) {
+        return false;
+    }
+    std::cout << "2." << std::endl;
+    std::cout << "1000000 words with random frequencies, k = 10, 1000 and 100000, 1 and 4 threads" << std::endl;
+    std::cout << "expected: the same frequencies as after sorting all of them" << std::endl;
+    std::vector<std::pair<std::string, int>> words;
+    std::srand(5);
+    for (int i = 0; i < 1000000; ++i) {
+        words.emplace_back(std::to_string(i), std::rand() % 100000);
+    }
+    std::sort(words.begin(), words.end());
+    d.assign(words.begin(), words.end());
+    std::vector<int> frequencies;
+    for (auto& word : words) {
+        frequencies.push_back(word.second);
+    }
+    std::sort(frequencies.begin(), frequencies.end(), std::greater<int>());
+    bool same = true;
+    for (std::size_t k : { 10, 1000, 100000 }) {
+        //with the ties all of the words with the frequency of the k-th one are included
+        std::size_t withTies = std::upper_bound(frequencies.begin(), frequencies.end(), frequencies[k - 1], std::greater<int>()) - frequencies.begin();
+        std::cout << "k = " << k << ":";
+        for (unsigned threads : { 1u, 4u }) {
+            for (bool exactly : { true, false }) {
+                auto start = std::chrono::steady_clock::now();
+                std::vector<Counts::iterator> best = topK(d, k, exactly, more, threads);
+                double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                same = same and best.size() == (exactly ? k : withTies);
+                for (std::size_t i = 0; same and i < best.size(); ++i) {
+                    same = best[i].getInfo() == frequencies[i];
+                }
+                std::cout << " " << threads << (threads == 1 ? " thread " : " threads ") << (exactly ? "exact " : "ties ") << time * 1000 << " ms,";
+            }
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "output: " << (same ? "the same frequencies" : "different frequencies") << std::endl;
+    return same;
+}
+bool frequencyIndex() {
+    std::cout << "---frequency index." << std::endl;
+    typedef FrequencyDictionary<std::string, int, ThreeWayCompare<>> Frequencies;
+    std::cout << "1." << std::endl;
+    std::cout << "first_testbench.txt counted with WordCounter, the best 2, the worst 2, counts >= 10" << std::endl;
+    std::cout << "expected: top first 20, second 15; bottom fifth 4, fourth 5; at least 10: third, second, first" << std::endl;
+    std::ifstream file("first_testbench.txt", std::ios::binary);
+    WordCounter<Frequencies> counter;
+    counter.readAll(file);
+    const Frequencies& words = counter.get();
+    std::vector<std::pair<std::string, int>> top = words.top(2), bottom = words.bottom(2), frequent = words.atLeast(10);
+    std::cout << "output: top " << top[0].first << " " << top[0].second << ", " << top[1].first << " " << top[1].second
+        << "; bottom " << bottom[0].first << " " << bottom[0].second << ", " << bottom[1].first << " " << bottom[1].second << "; at least 10:";
+    for (auto& word : frequent) {
+        std::cout << " " << word.first;
+    }
+    std::cout << std::endl;
+    if (top.size() != 2 or top[0].first != "first" or top[1].second != 15 or bottom[0].first != "fifth" or bottom[1].second != 5
+        or frequent.size() != 3 or frequent[0].first != "third" or frequent[2].first != "first") {
+        return false;
+    }
+    std::cout << "2." << std::endl;
+    std::cout << "200000 random increments, decrements and removals of 1000 keys compared with a plain Dictionary and topK after every 1000" << std::endl;
+    std::cout << "expected: the same counts, top, bottom and atLeast every time" << std::endl;
+    FrequencyDictionary<int> d;
+    Dictionary<int, int> plain;
+    auto more = [](const Dictionary<int, int>::iterator& a, const Dictionary<int, int>::iterator& b) { return a.getInfo() > b.getInfo(); };
+    auto less = [](const Dictionary<int, int>::iterator& a, const Dictionary<int, int>::iterator& b) { return a.getInfo() < b.getInfo(); };
+    std::srand(3);
+    bool same = true;
+    for (int i = 1; same and i <= 200000; ++i) {
+        int key = std::rand() % 1000, operation = std::rand() % 10;
+        if (operation == 0) {
+            same = d.remove(key) == plain.remove(key);
+        }
+        else {
+            int delta = operation < 8 ? 1 : -1;
+            plain.upsert(key, [delta](int& count) { count += delta; });
+            same = d.increment(key, delta) == plain.find(key).getInfo();
+        }
+        if (i % 1000 == 0) {
+            std::vector<std::pair<int, int>> best = d.top(10, false), worst = d.bottom(10, false), frequent = d.atLeast(60);
+            std::vector<Dictionary<int, int>::iterator> bestPlain = topK(plain, 10, false, more), worstPlain = topK(plain, 10, false, less);
+            same = same and d.size() == plain.size() and best.size() == bestPlain.size() and worst.size() == worstPlain.size();
+            for (std::size_t j = 0; same and j < best.size(); ++j) {
+                same = best[j].second == bestPlain[j].getInfo() and plain.find(best[j].first).getInfo() == best[j].second;
+            }
+            for (std::size_t j = 0; same and j < worst.size(); ++j) {
+                same = worst[j].second == worstPlain[j].getInfo() and plain.find(worst[j].first).getInfo() == worst[j].second;
+            }
+            std::size_t atLeast = 0;
+            plain.executeForAllNodes([&atLeast](Dictionary<int, int>::const_iterator& it) { atLeast += it.getInfo() >= 60; });
+            same = same and frequent.size() == atLeast and (frequent.empty() or frequent.front().second >= 60);
+        }
+    }
+    std::cout << "output: " << (same ? "the same" : "different") << std::endl;
+    if (!same) {
+        return false;
+    }
+    std::cout << "3." << std::endl;
+    std::cout << "top 10 of 1000000 keys from the index and with topK (scanning)" << std::endl;
+    std::cout << "expected: the same counts, the index is faster" << std::endl;
+    FrequencyDictionary<int> big;
+    Dictionary<int, int> bigPlain;
+    for (int i = 0; i < 1000000; ++i) {
+        int count = std::rand() % 100000;
+        big.increment(i, count);
+        bigPlain.insert(i, count);
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::pair<int, int>> best = big.top(10);
+    double indexTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    std::vector<Dictionary<int, int>::iterator> bestPlain = topK(bigPlain, 10, true, more);
+    double scanTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    same = best.size() == 10 and bestPlain.size() == 10;
+    for (std::size_t j = 0; same and j < best.size(); ++j) {
+        same = best[j].second == bestPlain[j].getInfo();
+    }
+    std::cout << "output: " << (same ? "the same counts" : "different counts") << ", index " << indexTime * 1000000 << " us, topK " << scanTime * 1000000 << " us" << std::endl;
+    return same and indexTime < scanTime;
+}
+bool aggregateQueries() {
+    std::cout << "---aggregate queries." << std::endl;
+    typedef AggregateDictionary<std::string, int, SumAggregate<long long>, ThreeWayCompare<>> Sums;
+    std::cout << "1." << std::endl;
+    std::cout << "first_testbench.txt counted with WordCounter, the sum of the counts of all words and of the words in [f, g]" << std::endl;
+    std::cout << "expected: the same sums as a scan" << std::endl;
+    std::ifstream file("first_testbench.txt", std::ios::binary);
+    WordCounter<Sums> counter;
+    counter.readAll(file);
+    const Sums& words = counter.get();
+    long long all = 0, part = 0;
+    words.executeForAllNodes([&all, &part](Sums::const_iterator& it) {
+        all += it.getInfo();
+        if (it.getKey() >= "f" and it.getKey() <= "g")
+            part += it.getInfo();
+    });
+    std::cout << "output: all " << words.aggregate() << " (scan " << all << "), [f, g] " << words.aggregate("f", "g") << " (scan " << part << ")" << std::endl;
+    if (words.aggregate() != all or words.aggregate("f", "g") != part or words.aggregate("g", "f") != 0) {
+        return false;
+    }
+    std::cout << "the same sums with range-for over the dictionary and over range(f, g), the infos are read only" << std::endl;
+    std::cout << "expected: all " << all << ", [f, g] " << part << std::endl;
+    long long ranged = 0, rangedPart = 0;
+    for (const int& count : words) {
+        ranged += count;
+    }
+    for (auto count : words.range(std::string("f"), std::string("g"))) {
+        rangedPart += count;
+    }
+    std::cout << "output: all " << ranged << ", [f, g] " << rangedPart << std::endl;
+    if (ranged != all or rangedPart != part) {
+        return false;
+    }
+    std::cout << "2." << std::endl;
+    std::cout << "100000 random inserts, removals, upserts, modifications, extractions and set operations on 2000 keys with Sum and Max," << std::endl;
+    std::cout << "random ranges compared with a scan after every 1000" << std::endl;
+    std::cout << "expected: the same sums and maxima every time" << std::endl;
+    typedef AggregateDictionary<int, int, SumAggregate<long long>> Sum;
+    typedef AggregateDictionary<int, int, MaxAggregate<int>> Max;
+    Sum sum;
+    Max max;
+    std::srand(5);
+    bool same = true;
+    for (int i = 1; same and i <= 100000; ++i) {
+        int key = std::rand() % 2000, value = std::rand() % 1000 - 500, operation = std::rand() % 8;
+        if (operation == 0) {
+            sum.remove(key);
+            max.remove(key);
+        }
+        else if (operation == 1) {
+            sum.insert_or_assign(key, value);
+            max.insert_or_assign(key, value);
+        }
+        else if (operation == 2) {
+            sum.upsert(key, [value](int& x) { x += value; });
+            max.upsert(key, [value](int& x) { x += value; });
+        }
+        else if (operation == 3) {
+            Sum::iterator it = sum.find(key);
+            Max::iterator found = max.find(key);
+            if (!it.isNull()) {
+                it.modify([value](int& x) { x = value; });
+                found.modify([value](int& x) { x = value; });
+            }
+        }
+        else if (operation == 4 and sum.contains(key)) {
+            Sum::node_handle node = sum.extract(key);
+            node.info() = value;
+            sum.insert(std::move(node));
+            Max::node_handle other = max.extract(key);
+            other.info() = value;
+            max.insert(std::move(other));
+        }
+        else if (operation == 5 and i % 500 == 0) {
+            Sum sumOther;
+            Max maxOther;
+            for (int j = 0; j < 100; ++j) {
+                int k = std::rand() % 2000;
+                sumOther.insert(k, j);
+                maxOther.insert(k, j);
+            }
+            sum.union_with(sumOther);
+            max.union_with(maxOther);
+            if (i % 1000 == 0) {
+                sum.difference(sumOther);
+                max.difference(maxOther);
+            }
+            sum = Sum(sum);
+            max = Max(max);
+        }
+        else {
+            sum.insert(key, value);
+            max.insert(key, value);
+        }
+        if (i % 1000 == 0) {
+            for (int j = 0; same and j < 20; ++j) {
+                int lo = std::rand() % 2100 - 50, hi = lo + std::rand() % 500;
+                long long scanSum = 0;
+                int scanMax = std::numeric_limits<int>::lowest();
+                sum.executeForAllNodes([&scanSum, lo, hi](Sum::const_iterator& it) {
+                    if (it.getKey() >= lo and it.getKey() <= hi)
+                        scanSum += it.getInfo();
+                });
+                max.executeForAllNodes([&scanMax, lo, hi](Max::const_iterator& it) {
+                    if (it.getKey() >= lo and it.getKey() <= hi)
+                        scanMax = std::max(scanMax, it.getInfo());
+                });
+                same = sum.aggregate(lo, hi) == scanSum and max.aggregate(lo, hi) == scanMax and sum.size() == max.size();
+            }
+        }
+    }
+    std::cout << "output: " << (same ? "the same" : "different") << std::endl;
+    return same;
+}
+bool rangeScans() {
+    std::cout << "---range scans and prefix search." << std::endl;
+    typedef Dictionary<std::string, int, ThreeWayCompare<>> Words;
+    std::cout << "1." << std::endl;
+    std::cout << "first_testbench.txt counted with WordCounter, words with prefix \"f\", words in [s, u]" << std::endl;
+    std::cout << "expected: fifth first fourth; second third" << std::endl;
+    std::ifstream file("first_testbench.txt", std::ios::binary);
+    WordCounter<Words> counter;
+    counter.readAll(file);
+    const Words& words = counter.get();
+    std::string withPrefix, inRange;
+    Words::range_view view = words.prefix("f");
+    for (Words::iterator it = view.begin(); it != view.end(); ++it) {
+        withPrefix += it.getKey() + " ";
+    }
+    words.visit_range(std::string_view("s"), std::string_view("u"), [&inRange](Words::const_iterator& it) { inRange += it.getKey() + " "; });
+    std::cout << "output: " << withPrefix << "; " << inRange << std::endl;
+    if (withPrefix != "fifth first fourth " or inRange != "second third ") {
+        return false;
+    }
+    std::cout << "2." << std::endl;
+    std::cout << "2000 random ranges of 20000 keys with range and visit_range, 2000 random prefixes of 20000 words" << std::endl;
+    std::cout << "expected: the same elements as a scan" << std::endl;
+    Dictionary<int, int> numbers;
+    std::srand(9);
+    for (int i = 0; i < 20000; ++i) {
+        numbers.insert(std::rand() % 50000, i);
+    }
+    bool same = true;
+    for (int i = 0; same and i < 2000; ++i) {
+        int lo = std::rand() % 52000 - 1000, hi = lo + std::rand() % 3000 - 200;
+        std::vector<int> byRange, byVisit, byScan;
+        Dictionary<int, int>::range_view part = numbers.range(lo, hi);
+        for (Dictionary<int, int>::iterator it = part.begin(); it != part.end(); ++it) {
+            byRange.push_back(it.getKey());
+        }
+        numbers.visit_range(lo, hi, [&byVisit](Dictionary<int, int>::const_iterator& it) { byVisit.push_back(it.getKey()); });
+        numbers.executeForAllNodes([&byScan, lo, hi](Dictionary<int, int>::const_iterator& it) {
+            if (it.getKey() >= lo and it.getKey() <= hi)
+                byScan.push_back(it.getKey());
+        }, Dictionary<int, int>::TravelType::Inorder);
+        same = byRange == byScan and byVisit == byScan;
+    }
+    Words dictionary;
+    const char letters[] = { 'a', 'b', 'z', '\xfe', '\xff' };
+    for (int i = 0; i < 20000; ++i) {
+        std::string word;
+        for (int j = std::rand() % 6; j > 0; --j) {
+            word += letters[std::rand() % 5];
+        }
+        dictionary.insert(word, i);
+    }
+    for (int i = 0; same and i < 2000; ++i) {
+        std::string prefix;
+        for (int j = std::rand() % 4; j > 0; --j) {
+            prefix += letters[std::rand() % 5];
+        }
+        std::vector<std::string> byPrefix, byScan;
+        Words::range_view part = dictionary.prefix(prefix);
+        for (Words::iterator it = part.begin(); it != part.end(); ++it) {
+            byPrefix.push_back(it.getKey());
+        }
+        for (Words::iterator it = dictionary.begin(); it != dictionary.end(); ++it) {
+            if (it.getKey().compare(0, prefix.size(), prefix) == 0)
+                byScan.push_back(it.getKey());
+        }
+        same = byPrefix == byScan;
+    }
+    std::cout << "output: " << (same ? "the same" : "different") << std::endl;
+    if (!same) {
+        return false;
+    }
+    std::cout << "3." << std::endl;
+    std::cout << "10 completions of 100 prefixes in 200000 words with prefix and by skipping from begin()" << std::endl;
+    std::cout << "expected: the same completions, prefix is faster" << std::endl;
+    Words big;
+    for (int i = 0; i < 200000; ++i) {
+        std::string word;
+        for (int j = 0; j < 8; ++j) {
+            word += char('a' + std::rand() % 26);
+        }
+        big.insert(word, i);
+    }
+    std::vector<std::string> prefixes;
+    for (int i = 0; i < 100; ++i) {
+        prefixes.push_back(std::string(1, char('a' + std::rand() % 26)) + char('a' + std::rand() % 26));
+    }
+    std::size_t fromView = 0, fromScan = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const std::string& prefix : prefixes) {
+        Words::range_view part = big.prefix(prefix);
+        int taken = 0;
+        for (Words::iterator it = part.begin(); it != part.end() and taken < 10; ++it, ++taken) {
+            fromView += it.getKey().size();
+        }
+    }
+    double viewTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    for (const std::string& prefix : prefixes) {
+        int taken = 0;
+        for (Words::iterator it = big.begin(); it != big.end() and taken < 10; ++it) {
+            if (it.getKey().compare(0, prefix.size(), prefix) == 0) {
+                fromScan += it.getKey().size();
+                ++taken;
+            }
+            else if (taken > 0) {
+                break;
+            }
+        }
+    }
+    double scanTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "output: " << (fromView == fromScan ? "the same" : "different") << ", prefix " << viewTime * 1000 << " ms, skipping " << scanTime * 1000 << " ms" << std::endl;
+    return fromView == fromScan and viewTime < scanTime;
+}
+struct Position {
+    int line;
+    double weight;
+};
+//serializer trait of a user type, used by save and load
+template<>
+struct Serializer<Position> {
+    static void write(std::string& out, const Position& x) {
+        Serializer<int>::write(out, x.line);
+        Serializer<double>::write(out, x.weight);
+    }
+    static Position read(const char*& p, const char* end) {
+        Position x;
+        x.line = Serializer<int>::read(p, end);
+        x.weight = Serializer<double>::read(p, end);
+        return x;
+    }
+};
+bool snapshotSaveLoad() {
+    std::cout << "---snapshot save and load." << std::endl;
+    std::cout << "1." << std::endl;
+    std::cout << "first_testbench.txt saved and loaded into a tree with other elements, a tree of user type infos saved and loaded" << std::endl;
+    std::cout << "expected: the same elements" << std::endl;
+    const char* name = "snapshot.bin";
+    Dictionary<std::string, int, ThreeWayCompare<>> words = readFile("first_testbench.txt"), loaded;
+    loaded.insert("other", 1);
+    words.save(name);
+    loaded.load(name);
+    Dictionary<int, Position> positions, loadedPositions;
+    for (int i = -1000; i < 1000; ++i) {
+        positions.insert(i * 31, Position{ i, i / 4.0 });
+    }
+    positions.save(name);
+    loadedPositions.load(name);
+    bool same = sameElements(words, loaded) and positions.size() == loadedPositions.size();
+    for (Dictionary<int, Position>::iterator it = positions.begin(); same and it != positions.end(); ++it) {
+        Dictionary<int, Position>::iterator found = loadedPositions.find(it.getKey());
+        same = !found.isNull() and found.getInfo().line == it.getInfo().line and found.getInfo().weight == it.getInfo().weight;
+    }
+    std::cout << "output: " << (same ? "the same" : "different") << std::endl;
+    if (!same) {
+        return false;
+    }
+    std::cout << "2." << std::endl;
+    std::cout << "a snapshot loaded into a non-empty dictionary using a pool" << std::endl;
+    std::cout << "expected: the same elements" << std::endl;
+    Dictionary<int, int> numbers;
+    Dictionary<int, int, std::less<int>, PoolAllocator<std::pair<const int, int>>> pooled;
+    for (int i = 0; i < 1000; ++i) {
+        numbers.insert(i * 7, -i);
+        pooled.insert(i * 5 + 1, i);
+    }
+    numbers.save(name);
+    pooled.load(name);
+    same = sameElements(numbers, pooled);
+    std::cout << "output: " << (same ? "the same" : "different") << std::endl;
+    if (!same) {
+        return false;
+    }
+    std::cout << "3." << std::endl;
+    std::cout << "one byte of the snapshot changed, the number of elements in the header changed, the snapshot cut, a text file and a missing file loaded" << std::endl;
+    std::cout << "expected: Snapshot is corrupted! Snapshot is corrupted! Snapshot is corrupted! Not a dictionary snapshot! Could not open the file! and the tree is not changed" << std::endl;
+    words.save(name);
+    std::string bytes;
+    {
+        std::ifstream in(name, std::ios::binary);
+        std::stringstream content;
+        content << in.rdbuf();
+        bytes = content.str();
+    }
+    std::string changed = bytes, miscounted = bytes, cut = bytes.substr(0, bytes.size() - 3);
+    changed[40] ^= 1;
+    //the highest byte of the number of elements
+    miscounted[23] ^= 0x40;
+    std::string messages;
+    for (const std::string& content : { changed, miscounted, cut }) {
+        std::ofstream(name, std::ios::binary) << content;
+        try {
+            loaded.load(name);
+        }
+        catch (const char* message) {
+            messages += std::string(message) + " ";
+        }
+    }
+    for (const char* file : { "first_testbench.txt", "missing_snapshot.bin" }) {
+        try {
+            loaded.load(file);
+        }
+        catch (const char* message) {
+            messages += std::string(message) + " ";
+        }
+    }
+    std::cout << "output: " << messages << "and the tree is " << (sameElements(words, loaded) ? "not changed" : "changed") << std::endl;
+    if (messages != "Snapshot is corrupted! Snapshot is corrupted! Snapshot is corrupted! Not a dictionary snapshot! Could not open the file! " or !sameElements(words, loaded)) {
+        return false;
+    }
+    std::cout << "4." << std::endl;
+    std::cout << "16 MB file with 100000 different words read with readFile, saved and loaded" << std::endl;
+    std::cout << "expected: the same counts (the times are only printed, benchmark.cpp compares them in its count text file and load rows)" << std::endl;
+    const char* text = "snapshot_text.txt";
+    {
+        std::ofstream out(text, std::ios::binary);
+        std::string content;
+        for (unsigned i = 0; content.size() < (16u << 20); ++i) {
+            for (unsigned word = i * 7919 % 100000 + 1; word; word /= 26) {
+                content += char('a' + word % 26);
+            }
+            content += i % 10 ? ' ' : '\n';
+        }
+        out << content;
+    }
+    auto start = std::chrono::steady_clock::now();
+    Dictionary<std::string, int, ThreeWayCompare<>> counted = readFile(text);
+    double readTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    counted.save(name);
+    double saveTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::ifstream snapshot(name, std::ios::binary | std::ios::ate);
+    double megabytes = double(snapshot.tellg()) / (1 << 20);
+    snapshot.close();
+    Dictionary<std::string, int, ThreeWayCompare<>> restored;
+    start = std::chrono::steady_clock::now();
+    restored.load(name);
+    double loadTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::remove(text);
+    std::remove(name);
+    same = counted.size() == 100000 and sameElements(counted, restored);
+    std::cout << "output: " << (same ? "the same counts" : "different counts") << ", readFile " << readTime * 1000 << " ms, save " << saveTime * 1000
+        << " ms, load " << loadTime * 1000 << " ms (" << megabytes << " MB, " << megabytes / 1024 / loadTime << " GB/s, "
+        << restored.size() / loadTime / 1000000 << " million elements/s)" << std::endl;
+    return same;
+}
+bool frequencyTest() 
+{
+    //the frequency testing is starting from an example from the lecture
+    Dictionary<std::string, int, ThreeWayCompare<>> d;
+    d.insert("Warsaw", 33);
+    d.insert("Cracow", 20);
+    d.insert("Gdansk", 10);
+    d.insert("Szczecin", 10);
+    std::cout << "max = 3, exact = true" << std::endl;
+    printMaxFrequency(d, 3, true);
+    std::cout << "max = 3, exact = false" << std::endl;
+    printMaxFrequency(d, 3, false);
+    //not enaught elements case
+    std::cout << "max = 5, exact = false" << std::endl;
+    printMaxFrequency(d, 5, false);
+    //negative max
+    std::cout << "max = -5, exact = false" << std::endl;
+    try {
+        printMaxFrequency(d, -5, false);
+    }
+    catch (const char* err) {
+        std::cout << err;
+    }
+    
+    return true;
+}
+int main()
+{
+    std::cout << "\n\n AVLRotations() \n\n";
+    AVLRotations();
+    std::cout << "\n\n basicFunctionalities() \n\n";
+    if (!basicFunctionalities()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n iterators() \n\n";
+    if (!iterators()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n orderedLookups() \n\n";
+    if (!orderedLookups()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n orderStatistics() \n\n";
+    if (!orderStatistics()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n bulkLoad() \n\n";
+    if (!bulkLoad()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n setAlgebra() \n\n";
+    if (!setAlgebra()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n moveSemantics() \n\n";
+    if (!moveSemantics()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n poolAllocation() \n\n";
+    if (!poolAllocation()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n compactLayout() \n\n";
+    if (!compactLayout()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n frozenLookups() \n\n";
+    if (!frozenLookups()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n bplusStorage() \n\n";
+    if (!bplusStorage()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n transparentLookups() \n\n";
+    if (!transparentLookups()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n threeWayComparisons() \n\n";
+    if (!threeWayComparisons()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n concurrentAccess() \n\n";
+    if (!concurrentAccess()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n persistentSnapshots() \n\n";
+    if (!persistentSnapshots()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n shardedCounting() \n\n";
+    if (!shardedCounting()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n parallelReadFile() \n\n";
+    if (!parallelReadFile()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n mappedReadFile() \n\n";
+    if (!mappedReadFile()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n streamingCounting() \n\n";
+    if (!streamingCounting()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n topKFrequencies() \n\n";
+    if (!topKFrequencies()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n frequencyIndex() \n\n";
+    if (!frequencyIndex()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n aggregateQueries() \n\n";
+    if (!aggregateQueries()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n rangeScans() \n\n";
+    if (!rangeScans()) {
+        std::cout << "error";
+        return 0;
+    }
+    std::cout << "\n\n snapshotSaveLoad() \n\n";
+    if (!snapshotSaveLoad()) {
         std::cout << "error";
         return 0;
     }